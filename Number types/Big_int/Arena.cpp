@@ -0,0 +1,104 @@
+#include "Arena.h"
+
+#include <algorithm>
+
+namespace {
+
+thread_local std::pmr::memory_resource* installed = nullptr;
+
+} // namespace
+
+//! allocation_stats
+
+void allocation_stats::on_allocate(std::size_t bytes) {
+    allocations++;
+    bytes_in_use += bytes;
+    peak_bytes_in_use = std::max(peak_bytes_in_use, bytes_in_use);
+}
+
+void allocation_stats::on_deallocate(std::size_t bytes) {
+    deallocations++;
+    bytes_in_use -= bytes;
+}
+
+//! arena
+
+arena::arena(std::size_t chunk_size, std::pmr::memory_resource* upstream):
+    upstream(upstream), chunks(nullptr), position(nullptr), end(nullptr), next_chunk_size(chunk_size) {}
+
+arena::~arena() {
+    release();
+}
+
+void arena::add_chunk(std::size_t bytes) {
+    std::size_t size = std::max(next_chunk_size, bytes);
+    next_chunk_size = 2 * size;
+
+    chunk* fresh = static_cast<chunk*>(upstream->allocate(sizeof(chunk) + size, alignof(std::max_align_t)));
+    fresh->next = chunks;
+    fresh->size = size;
+
+    chunks = fresh;
+    position = reinterpret_cast<char*>(fresh + 1);
+    end = position + size;
+
+    statistics.system_allocations++;
+}
+
+void* arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* pointer = position;
+    std::size_t space = end - position;
+
+    if (!chunks || !std::align(alignment, bytes, pointer, space)) {
+        add_chunk(bytes + alignment);
+
+        pointer = position;
+        space = end - position;
+        std::align(alignment, bytes, pointer, space);
+    }
+
+    position = static_cast<char*>(pointer) + bytes;
+    statistics.on_allocate(bytes);
+
+    return pointer;
+}
+
+void arena::do_deallocate(void* pointer, std::size_t bytes, std::size_t) {
+    // Only the latest block can be handed back, the rest waits for release()
+    if (static_cast<char*>(pointer) + bytes == position) position = static_cast<char*>(pointer);
+
+    statistics.on_deallocate(bytes);
+}
+
+bool arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void arena::release() {
+    while (chunks) {
+        chunk* next = chunks->next;
+        upstream->deallocate(chunks, sizeof(chunk) + chunks->size, alignof(std::max_align_t));
+        chunks = next;
+    }
+
+    position = end = nullptr;
+    statistics.bytes_in_use = 0;
+}
+
+const allocation_stats& arena::stats() const {
+    return statistics;
+}
+
+//! memory_scope
+
+memory_scope::memory_scope(std::pmr::memory_resource* resource): previous(installed) {
+    installed = resource;
+}
+
+memory_scope::~memory_scope() {
+    installed = previous;
+}
+
+std::pmr::memory_resource* current_resource() {
+    return installed;
+}
@@ -0,0 +1,135 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+//! Pluggable memory for bigint limbs, and for any standard container through scoped_allocator.
+//!
+//! A memory_scope installs a std::pmr::memory_resource for the current thread.
+//! Buffers created while it is active take their memory from that resource, for
+//! example an arena, so a whole computation can be released in one shot:
+//!
+//!     arena memory;
+//!     {
+//!         memory_scope scope(&memory);
+//!         ... big polynomial<fraction<bigint>> computation ...
+//!     }
+//!     memory.release();
+//!
+//! Values built inside the scope must not outlive the resource. Assigning them to
+//! variables created outside the scope copies them into those variables' memory.
+
+struct allocation_stats {
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t system_allocations = 0; // requests that reached the upstream allocator
+    std::size_t bytes_in_use = 0;
+    std::size_t peak_bytes_in_use = 0;
+
+    void on_allocate(std::size_t bytes);
+    void on_deallocate(std::size_t bytes);
+};
+
+//! Bump allocator: memory is taken from growing chunks and only returned by release()
+//! or the destructor. Freeing the most recent block gives its memory back immediately.
+//! Not thread-safe
+class arena : public std::pmr::memory_resource {
+private:
+    struct chunk {
+        chunk* next;
+        std::size_t size;
+    };
+
+    std::pmr::memory_resource* upstream;
+    chunk* chunks; // newest first
+    char* position;
+    char* end;
+    std::size_t next_chunk_size;
+    allocation_stats statistics;
+
+    void add_chunk(std::size_t bytes);
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+public:
+    //! Rule of five
+    explicit arena(std::size_t chunk_size = 1 << 16, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    arena(const arena& other) = delete;
+    ~arena() override;
+
+    arena& operator=(const arena& other) = delete;
+
+    //! Methods
+
+    //! Frees every chunk, invalidating all memory handed out so far
+    void release();
+
+    const allocation_stats& stats() const;
+};
+
+//! Installs resource as the current thread's memory until the scope ends.
+//! nullptr switches back to the global heap, e.g. for caches that outlive the scope
+class memory_scope {
+private:
+    std::pmr::memory_resource* previous;
+public:
+    //! Rule of five
+    explicit memory_scope(std::pmr::memory_resource* resource);
+    memory_scope(const memory_scope& other) = delete;
+    ~memory_scope();
+
+    memory_scope& operator=(const memory_scope& other) = delete;
+};
+
+//! The resource installed by the innermost memory_scope, nullptr for the global heap
+std::pmr::memory_resource* current_resource();
+
+//! Standard allocator over the resource that was current when it was created,
+//! so standard containers follow memory_scope too. Copies of a container pick up
+//! the resource current at the time of the copy
+template<typename T>
+class scoped_allocator {
+private:
+    std::pmr::memory_resource* memory;
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+
+    scoped_allocator() noexcept: memory(current_resource()) {}
+
+    template<typename U>
+    scoped_allocator(const scoped_allocator<U>& other) noexcept: memory(other.resource()) {}
+
+    T* allocate(std::size_t n) {
+        if (!memory) return std::allocator<T>().allocate(n);
+        return static_cast<T*>(memory->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n) {
+        if (!memory) std::allocator<T>().deallocate(pointer, n);
+        else memory->deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    scoped_allocator select_on_container_copy_construction() const {
+        return scoped_allocator();
+    }
+
+    std::pmr::memory_resource* resource() const {
+        return memory;
+    }
+
+    template<typename U>
+    bool operator==(const scoped_allocator<U>& other) const {
+        return memory == other.resource();
+    }
+
+    template<typename U>
+    bool operator!=(const scoped_allocator<U>& other) const {
+        return memory != other.resource();
+    }
+};
+
+#endif // ARENA_H
@@ -1,48 +1,175 @@
 #include "Bigint.h"
 
-//! Rule of five
+#include <algorithm>
+#include <stdexcept>
 
-bigint::bigint(): sign(1), digits(std::vector<int>(1, 0)) {}
+namespace {
 
-bigint::bigint(long long value) { *this = value; }
+using limb = bigint::limb;
 
-bigint::bigint(const bigint &other): sign(other.sign), digits(other.digits) {}
+int cmp_magnitudes(const limb_buffer& a, const limb_buffer& b) {
+    return limbs::cmp(a.data(), a.size(), b.data(), b.size());
+}
 
-bigint& bigint::operator=(long long value) {
-    sign = 1;
-    if (value < 0) {
-        sign = -1;
-        value *= -1;
+//! result = |a| + |b|
+limb_buffer add_magnitudes(const limb_buffer& a, const limb_buffer& b) {
+    const limb_buffer& longer = (a.size() >= b.size() ? a : b);
+    const limb_buffer& shorter = (a.size() >= b.size() ? b : a);
+
+    limb_buffer result(longer.size() + 1);
+    result.back() = limbs::add(result.data(), longer.data(), longer.size(), shorter.data(), shorter.size());
+
+    if (!result.back()) result.pop_back();
+    return result;
+}
+
+//! result = |a| - |b|, requires |a| >= |b|
+limb_buffer sub_magnitudes(const limb_buffer& a, const limb_buffer& b) {
+    limb_buffer result(a.size());
+    limbs::sub(result.data(), a.data(), a.size(), b.data(), b.size());
+
+    result.resize(limbs::normalized_size(result.data(), result.size()));
+    return result;
+}
+
+//! self + other_sign * |other|
+bigint add_signed(const bigint& self, const bigint& other, int other_sign) {
+    bigint result;
+
+    if (self._sign() == other_sign) {
+        result._limbs() = add_magnitudes(self._limbs(), other._limbs());
+        result._sign() = self._sign();
+    }
+    else if (cmp_magnitudes(self._limbs(), other._limbs()) >= 0) {
+        result._limbs() = sub_magnitudes(self._limbs(), other._limbs());
+        result._sign() = self._sign();
+    }
+    else {
+        result._limbs() = sub_magnitudes(other._limbs(), self._limbs());
+        result._sign() = other_sign;
     }
 
-    digits.clear();
+    result.trim_zeros();
+    return result;
+}
 
-    while (value > 0) {
-        digits.push_back(value % 10);
-        value /= 10;
+//! r = |a| * |b|, r must not alias a or b
+void multiply_magnitudes(limb_buffer& r, const limb_buffer& x, const limb_buffer& y, mul_algorithm algorithm) {
+    if (x.empty() || y.empty()) {
+        r.clear();
+        return;
     }
 
+    const limb_buffer& a = (x.size() >= y.size() ? x : y);
+    const limb_buffer& b = (x.size() >= y.size() ? y : x);
+
+    std::size_t an = a.size(), bn = b.size();
+    r.resize(an + bn);
+
+    if (algorithm == mul_algorithm::karatsuba && bn <= (an + 1) / 2) algorithm = mul_algorithm::automatic;
+    if (algorithm == mul_algorithm::toom3 && bn <= 2 * ((an + 2) / 3)) algorithm = mul_algorithm::automatic;
+
+    switch (algorithm) {
+        case mul_algorithm::schoolbook:
+            limbs::mul_basecase(r.data(), a.data(), an, b.data(), bn);
+            break;
+        case mul_algorithm::karatsuba:
+            limbs::mul_karatsuba(r.data(), a.data(), an, b.data(), bn);
+            break;
+        case mul_algorithm::toom3:
+            limbs::mul_toom3(r.data(), a.data(), an, b.data(), bn);
+            break;
+        case mul_algorithm::ntt:
+            if (an + bn > limbs::ntt_max_limbs) throw std::length_error("bigint: operands too long for the NTT");
+            limbs::mul_ntt(r.data(), a.data(), an, b.data(), bn);
+            break;
+        default:
+            limbs::mul(r.data(), a.data(), an, b.data(), bn);
+    }
+
+    r.resize(limbs::normalized_size(r.data(), r.size()));
+}
+
+} // namespace
+
+//! Rule of five
+
+bigint::bigint(): sign(1) {}
+
+bigint::bigint(long long value) { *this = value; }
+
+bigint::bigint(const std::string& value) {
+    const char* first = value.data();
+    const char* last = first + value.size();
+
+    if (first != last && *first == '+') first++;
+
+    std::from_chars_result parsed = from_chars(first, last, *this);
+    if (parsed.ec != std::errc() || parsed.ptr != last) throw std::invalid_argument("bigint: not a decimal number");
+}
+
+bigint::bigint(const bigint &other): limbs(other.limbs), sign(other.sign) {}
+
+bigint::bigint(bigint &&other) noexcept: limbs(std::move(other.limbs)), sign(other.sign) {
+    other.sign = 1;
+}
+
+bigint& bigint::operator=(long long value) {
+    sign = (value < 0 ? -1 : 1);
+    limbs.clear();
+
+    // Negating through unsigned keeps LLONG_MIN well-defined
+    limb magnitude = (value < 0 ? 0 - static_cast<limb>(value) : static_cast<limb>(value));
+    if (magnitude) limbs.push_back(magnitude);
+
     return *this;
 }
 
 bigint& bigint::operator=(const bigint &other) {
     sign = other.sign;
-    digits = other.digits;
+    limbs = other.limbs;
+
+    return *this;
+}
+
+bigint& bigint::operator=(bigint &&other) noexcept {
+    sign = other.sign;
+    limbs = std::move(other.limbs);
 
+    if (this != &other) other.sign = 1;
     return *this;
 }
 
 //! In-class methods
 
-std::string bigint::to_string() const {
-    std::string s;
+void bigint::add_in_place(const bigint &other, int other_sign) {
+    std::size_t m = other.limbs.size();
+
+    if (sign == other_sign) {
+        // Resizing cannot invalidate other here, other == *this implies equal sizes
+        if (limbs.size() < m) limbs.resize(m);
+
+        limb carry = limbs::add(limbs.data(), limbs.data(), limbs.size(), other.limbs.data(), m);
+        if (carry) limbs.push_back(carry);
+    }
+    else if (cmp_magnitudes(limbs, other.limbs) >= 0) {
+        limbs::sub(limbs.data(), limbs.data(), limbs.size(), other.limbs.data(), m);
+    }
+    else {
+        std::size_t n = limbs.size();
+        limbs.resize(m);
 
-    for (int i = digits.size() - 1; i >= 0; i--) {
-        s += std::to_string(digits[i]);
+        limbs::sub(limbs.data(), other.limbs.data(), m, limbs.data(), n);
+        sign = other_sign;
     }
 
-    if (sign == -1) s = '-' + s;
+    trim_zeros();
+}
 
+std::string bigint::to_string() const {
+    std::string s(max_decimal_length(*this), '\0');
+
+    s.resize(::to_chars(&s[0], &s[0] + s.size(), *this).ptr - s.data());
     return s;
 }
 
@@ -53,20 +180,17 @@ bigint bigint::abs() const  {
 }
 
 void bigint::trim_zeros() {
-    while (!digits.empty() && !digits.back()) digits.pop_back();
+    while (!limbs.empty() && !limbs.back()) limbs.pop_back();
 
-    if (digits.empty()) {
-        sign = 1;
-        digits.resize(1, 0);
-    }
+    if (limbs.empty()) sign = 1;
 }
 
-std::vector<int> &bigint::_digits() {
-    return digits;
+limb_buffer &bigint::_limbs() {
+    return limbs;
 }
 
-const std::vector<int> &bigint::_digits() const {
-    return digits;
+const limb_buffer &bigint::_limbs() const {
+    return limbs;
 }
 
 int &bigint::_sign() {
@@ -78,16 +202,12 @@ const int &bigint::_sign() const {
 }
 
 bigint::operator bool() const {
-    for (int i = 0; i < digits.size(); i++) {
-        if (digits[i]) return true;
-    }
-
-    return false;
+    return !limbs.empty();
 }
 
 bigint bigint::operator-() const  {
     bigint result = *this;
-    result.sign *= -1;
+    if (result) result.sign *= -1;
     return result;
 }
 
@@ -99,19 +219,36 @@ bigint bigint::operator+() const {
 //! In-class arithmetic operators
 
 bigint &bigint::operator+=(const bigint &other) {
-    *this = other + *this;
+    add_in_place(other, other.sign);
 
     return *this;
 }
 
 bigint &bigint::operator-=(const bigint &other) {
-    *this = *this - other;
+    add_in_place(other, -other.sign);
 
     return *this;
 }
 
 bigint &bigint::operator*=(const bigint &other)  {
-    *this = other * (*this);
+    // The product cannot overlap its operands, its storage comes from freed temporaries
+    limb_buffer product;
+    multiply_magnitudes(product, limbs, other.limbs, mul_algorithm::automatic);
+
+    limbs = std::move(product);
+    sign *= other.sign;
+    trim_zeros();
+
+    return *this;
+}
+
+bigint &bigint::operator/=(const bigint &other) {
+    *this = *this / other;
+    return *this;
+}
+
+bigint &bigint::operator%=(const bigint &other) {
+    *this = *this % other;
     return *this;
 }
 
@@ -140,94 +277,104 @@ const bigint bigint::operator--(int)  {
 //! Out-of-class arithmetic operators
 
 bigint operator+(const bigint& self, const bigint& other) {
-    if (self._sign() != other._sign()) return self - (-other);
-    bigint result = other;
-
-    for (int i = 0, carry = 0; i < std::max(self._digits().size(), other._digits().size()) || carry; i++) {
-        if (i == result._digits().size()) result._digits().push_back(0);
-
-        result._digits()[i] += carry + (i < self._digits().size() ? self._digits()[i] : 0);
-        carry = (result._digits()[i] >= 10);
-
-        if (carry) result._digits()[i] -= 10;
-    }
-
-    return result;
+    return add_signed(self, other, other._sign());
 }
 
 bigint operator-(const bigint& self, const bigint& other) {
-    if (self._sign() != other._sign()) return self + (-other);
-
-    if (self.abs() < other.abs()) return -(other - self);
+    return add_signed(self, other, -other._sign());
+}
 
-    bigint result = self;
+bigint operator*(const bigint& self, const bigint& other) {
+    return multiply(self, other, mul_algorithm::automatic);
+}
 
-    for (int i = 0, carry = 0; i < other._digits().size() || carry; i++) {
-        result._digits()[i] -= carry + (i < other._digits().size() ? other._digits()[i] : 0);
-        carry = result._digits()[i] < 0;
+bigint operator+(bigint&& self, const bigint& other) {
+    self += other;
+    return std::move(self);
+}
 
-        if (carry) result._digits()[i] += 10;
-    }
+bigint operator+(const bigint& self, bigint&& other) {
+    other += self;
+    return std::move(other);
+}
 
-    result.trim_zeros();
-    return result;
+bigint operator+(bigint&& self, bigint&& other) {
+    self += other;
+    return std::move(self);
 }
 
-bigint operator*(const bigint& self, const bigint& other) {
-    bigint result;
-    result._digits().resize(0);
+bigint operator-(bigint&& self, const bigint& other) {
+    self -= other;
+    return std::move(self);
+}
 
-    result._sign() = self._sign() * other._sign();
+bigint operator-(const bigint& self, bigint&& other) {
+    if (other) other._sign() *= -1;
 
-    for (int i = 0; i < self._digits().size(); i++) {
-        int carry = 0;
+    other += self;
+    return std::move(other);
+}
 
-        for (int j = 0; j < other._digits().size(); j++) {
-            int k = i + j;
+bigint operator-(bigint&& self, bigint&& other) {
+    self -= other;
+    return std::move(self);
+}
 
-            if (k == result._digits().size()) result._digits().push_back(0);
+bigint operator*(bigint&& self, const bigint& other) {
+    self *= other;
+    return std::move(self);
+}
 
-            long long prod = self._digits()[i] * other._digits()[j] + result._digits()[k] + carry;
-            result._digits()[k] = prod % 10;
-            carry = prod / 10;
-        }
+bigint operator*(const bigint& self, bigint&& other) {
+    other *= self;
+    return std::move(other);
+}
 
-        if (result._digits().size() == i + other._digits().size()) {
-            result._digits().push_back(0);
-        }
+bigint operator*(bigint&& self, bigint&& other) {
+    self *= other;
+    return std::move(self);
+}
 
-        result._digits()[i + other._digits().size()] += carry;
-    }
+bigint multiply(const bigint& self, const bigint& other, mul_algorithm algorithm) {
+    bigint result;
 
+    multiply_magnitudes(result._limbs(), self._limbs(), other._limbs(), algorithm);
+    result._sign() = self._sign() * other._sign();
     result.trim_zeros();
 
     return result;
 }
 
-//! Out-of-class non-arithmetic operators
 
-std::istream& operator>>(std::istream& stream, bigint& value) {
-    std::string s;
-    stream >> s;
+bigint operator/(const bigint& self, const bigint& other) {
+    return divmod(self, other).first;
+}
 
-    if (s[0] == '-') {
-        value._sign() = -1;
-        s = s.substr(1, s.size());
-    }
+bigint operator%(const bigint& self, const bigint& other) {
+    return divmod(self, other).second;
+}
 
-    value._digits().resize(s.size());
+std::pair<bigint, bigint> divmod(const bigint& self, const bigint& other) {
+    if (!other) throw std::runtime_error("Division by zero");
 
-    for (int i = s.size() - 1, j = 0; i >= 0; i--, j++) {
-        value._digits()[j] = s[i] - '0';
-    }
+    const limb_buffer& a = self._limbs();
+    const limb_buffer& b = other._limbs();
 
-    return stream;
-}
+    if (cmp_magnitudes(a, b) < 0) return {bigint(), self};
+
+    bigint quotient, remainder;
+    quotient._limbs().resize(a.size() - b.size() + 1);
+    remainder._limbs().resize(b.size());
+
+    limbs::divrem(quotient._limbs().data(), remainder._limbs().data(), a.data(), a.size(), b.data(), b.size());
 
-std::ostream& operator<<(std::ostream& stream, const bigint& value) {
-    stream << value.to_string();
+    quotient._sign() = self._sign() * other._sign();
+    remainder._sign() = self._sign();
 
-    return stream;
+    quotient.trim_zeros();
+    remainder.trim_zeros();
+
+    return {quotient, remainder};
 }
 
 //! Boolean operators
@@ -235,15 +382,9 @@ std::ostream& operator<<(std::ostream& stream, const bigint& value) {
 bool operator<(const bigint &self, const bigint &other) {
     if (self._sign() != other._sign()) return self._sign() < other._sign();
 
-    if (self._digits().size() != other._digits().size())
-        return self._sign() * self._digits().size() < other._sign() * other._digits().size();
-
-    for (int i = self._digits().size() - 1; i >= 0; i--) {
-        if (self._digits()[i] != other._digits()[i]) 
-            return self._sign() * self._digits()[i] < other._sign() * other._digits()[i];
-    }
+    int order = cmp_magnitudes(self._limbs(), other._limbs());
 
-    return false;
+    return (self._sign() == 1 ? order < 0 : order > 0);
 }
 
 bool operator>(const bigint& self, const bigint& other) {
@@ -259,7 +400,7 @@ bool operator<=(const bigint& self, const bigint& other) {
 }
 
 bool operator==(const bigint& self, const bigint& other) {
-    return (self <= other) && (self >= other);
+    return self._sign() == other._sign() && self._limbs() == other._limbs();
 }
 
 bool operator!=(const bigint& self, const bigint& other) {
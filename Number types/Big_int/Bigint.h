@@ -1,23 +1,37 @@
 #ifndef BIGINT_H
 #define BIGINT_H
 
+#include <charconv>
 #include <string>
 #include <vector>
 #include <iostream>
+#include <tuple>
+#include <utility>
+
+#include "Limb_buffer.h"
+#include "Limbs.h"
 
 class bigint {
+public:
+    using limb = limbs::limb;
 private:
-    std::vector<int> digits;
+    limb_buffer limbs; // magnitude in base 2^64, least significant limb first, no leading zero limbs
     int sign;
+
+    //! *this += other_sign * |other|, reusing the storage of *this
+    void add_in_place(const bigint& other, int other_sign);
 public:
     //! Rule of five
     bigint();
     bigint(long long value);
+    explicit bigint(const std::string& value);
     bigint(const bigint& other);
+    bigint(bigint&& other) noexcept;
     ~bigint() = default;
 
     bigint& operator=(long long value);
     bigint& operator=(const bigint& other);
+    bigint& operator=(bigint&& other) noexcept;
 
     //! In-class methods
 
@@ -25,8 +39,8 @@ public:
     bigint abs() const;
     void trim_zeros();
 
-    std::vector<int>& _digits();
-    const std::vector<int>& _digits() const;
+    limb_buffer& _limbs();
+    const limb_buffer& _limbs() const;
 
     int& _sign();
     const int& _sign() const;
@@ -41,6 +55,8 @@ public:
     bigint& operator+=(const bigint& other);
     bigint& operator-=(const bigint& other);
     bigint& operator*=(const bigint& other);
+    bigint& operator/=(const bigint& other);
+    bigint& operator%=(const bigint& other);
 
     bigint& operator++();
     const bigint operator++(int);
@@ -49,5 +65,81 @@ public:
     const bigint operator--(int);
 };
 
+//! Out-of-class arithmetic operators
+
+bigint operator+(const bigint& self, const bigint& other);
+bigint operator-(const bigint& self, const bigint& other);
+bigint operator*(const bigint& self, const bigint& other);
+bigint operator/(const bigint& self, const bigint& other);
+bigint operator%(const bigint& self, const bigint& other);
+
+//! Overloads for temporaries, which reuse the storage of the expiring operand
+
+bigint operator+(bigint&& self, const bigint& other);
+bigint operator+(const bigint& self, bigint&& other);
+bigint operator+(bigint&& self, bigint&& other);
+bigint operator-(bigint&& self, const bigint& other);
+bigint operator-(const bigint& self, bigint&& other);
+bigint operator-(bigint&& self, bigint&& other);
+bigint operator*(bigint&& self, const bigint& other);
+bigint operator*(const bigint& self, bigint&& other);
+bigint operator*(bigint&& self, bigint&& other);
+
+//! Quotient rounded toward zero and remainder with the sign of self, like the built-in integers.
+//! Throws std::runtime_error on division by zero
+std::pair<bigint, bigint> divmod(const bigint& self, const bigint& other);
+
+//! Greatest common divisor and least common multiple, both nonnegative, gcd(0, 0) = 0.
+//! Lehmer's algorithm, with a half-gcd recursion for large operands, see Gcd.cpp
+bigint gcd(const bigint& self, const bigint& other);
+bigint lcm(const bigint& self, const bigint& other);
+
+//! {g, x, y} with g = gcd(self, other) = self x + other y and |x| <= |other| / 2g
+std::tuple<bigint, bigint, bigint> xgcd(const bigint& self, const bigint& other);
+
+//! Roots rounded toward zero by Newton's iteration with precision doubling, within a constant
+//! factor of a multiplication, see Roots.cpp. Throw std::invalid_argument for even roots of
+//! negative numbers and for n = 0
+bigint isqrt(const bigint& self);
+bigint iroot(const bigint& self, std::size_t n);
+
+//! Residues modulo 64, 65535 and 641 reject almost all non-squares before any root is taken
+bool is_perfect_square(const bigint& self);
+
+//! {r, k} with self = r^k for the largest k, {self, 1} if there is no k > 1 (and for 0, 1, -1)
+std::pair<bigint, std::size_t> perfect_power(const bigint& self);
+
+//! Whether self = r^k for some k > 1, which includes 0, 1 and -1
+bool is_perfect_power(const bigint& self);
+
+//! Multiplication with a forced top-level algorithm, mainly for benchmarks.
+//! Karatsuba and Toom-3 fall back to the automatic choice when the operands are
+//! too unbalanced for them, NTT throws std::length_error above limbs::ntt_max_limbs
+enum class mul_algorithm { automatic, schoolbook, karatsuba, toom3, ntt };
+
+bigint multiply(const bigint& self, const bigint& other, mul_algorithm algorithm);
+
+//! Decimal conversion into and out of caller-supplied buffers, like std::to_chars and std::from_chars.
+//! Large values are split recursively at cached powers of 10^19, see Conversion.cpp
+
+std::to_chars_result to_chars(char* first, char* last, const bigint& value);
+std::from_chars_result from_chars(const char* first, const char* last, bigint& value);
+
+//! Buffer size that is always enough for to_chars
+std::size_t max_decimal_length(const bigint& value);
+
+//! Out-of-class non-arithmetic operators
+
+std::istream& operator>>(std::istream& stream, bigint& value);
+std::ostream& operator<<(std::ostream& stream, const bigint& value);
+
+//! Boolean operators
+
+bool operator<(const bigint& self, const bigint& other);
+bool operator>(const bigint& self, const bigint& other);
+bool operator>=(const bigint& self, const bigint& other);
+bool operator<=(const bigint& self, const bigint& other);
+bool operator==(const bigint& self, const bigint& other);
+bool operator!=(const bigint& self, const bigint& other);
 
-#endif /// BIGINT_H.
\ No newline at end of file
+#endif /// BIGINT_H.
@@ -0,0 +1,8 @@
+#include <iostream>
+#include "Bigint.h"
+
+int main() {
+    bigint a, b;
+    std::cin >> a >> b;
+    std::cout << a + b << " " << a - b << " " << a * b << " " << a / b << " " << a % b << " " << (a < b) << std::endl;
+}
@@ -0,0 +1,206 @@
+#include "Binary.h"
+#include "Bigint.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Limbs are used in place, so the format has to be the in-memory layout
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the binary format needs a little-endian target");
+
+namespace {
+
+using word = std::uint64_t;
+
+void truncated() {
+    throw std::runtime_error("binary: truncated data");
+}
+
+} // namespace
+
+//! binary_writer
+
+binary_writer::binary_writer(std::ostream& stream): stream(stream) {
+    put(binary_magic);
+    put(binary_version);
+}
+
+void binary_writer::put(word value) {
+    put(&value, 1);
+}
+
+void binary_writer::put(const word* values, std::size_t count) {
+    stream.write(reinterpret_cast<const char*>(values), count * sizeof(word));
+
+    if (!stream) throw std::runtime_error("binary: write failed");
+}
+
+//! binary_reader
+
+binary_reader::binary_reader(const word* first, const word* last): position(first), end(last) {}
+
+void binary_reader::expect_header() {
+    if (end - position < 2 || position[0] != binary_magic) throw std::runtime_error("binary: not a serialized file");
+    if (position[1] > binary_version) throw std::runtime_error("binary: unsupported format version");
+
+    position += 2;
+}
+
+word binary_reader::get() {
+    return *take(1);
+}
+
+const word* binary_reader::take(std::size_t count) {
+    if (static_cast<std::size_t>(end - position) < count) truncated();
+
+    const word* first = position;
+    position += count;
+    return first;
+}
+
+const word* binary_reader::current() const {
+    return position;
+}
+
+std::size_t binary_reader::remaining() const {
+    return end - position;
+}
+
+//! mapped_file
+
+mapped_file::mapped_file(const std::string& path): words(nullptr), length(0), bytes(0), handle(nullptr) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("mapped_file: cannot open " + path);
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("mapped_file: cannot open " + path);
+    }
+
+    bytes = static_cast<std::size_t>(file_size.QuadPart);
+
+    if (bytes) {
+        handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (handle) words = static_cast<const word*>(MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    CloseHandle(file);
+    if (bytes && !words) {
+        if (handle) CloseHandle(handle);
+        throw std::runtime_error("mapped_file: cannot map " + path);
+    }
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) throw std::runtime_error("mapped_file: cannot open " + path);
+
+    struct stat status;
+    if (fstat(file, &status) < 0) {
+        close(file);
+        throw std::runtime_error("mapped_file: cannot open " + path);
+    }
+
+    bytes = static_cast<std::size_t>(status.st_size);
+
+    if (bytes) {
+        void* memory = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, file, 0);
+        if (memory != MAP_FAILED) words = static_cast<const word*>(memory);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(file);
+    if (bytes && !words) throw std::runtime_error("mapped_file: cannot map " + path);
+#endif
+
+    // A trailing partial word is ignored, reading up to it reports truncated data
+    length = bytes / sizeof(word);
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept: words(other.words), length(other.length), bytes(other.bytes), handle(other.handle) {
+    other.words = nullptr;
+    other.length = 0;
+    other.bytes = 0;
+    other.handle = nullptr;
+}
+
+mapped_file::~mapped_file() {
+    if (!words) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(words);
+    CloseHandle(handle);
+#else
+    munmap(const_cast<word*>(words), bytes);
+#endif
+}
+
+const word* mapped_file::data() const {
+    return words;
+}
+
+std::size_t mapped_file::size() const {
+    return length;
+}
+
+binary_reader mapped_file::reader() const {
+    binary_reader result(words, words + length);
+    result.expect_header();
+    return result;
+}
+
+//! bigint_view
+
+bigint_view::bigint_view(binary_reader& reader) {
+    word header = reader.get();
+
+    length = header >> 1;
+    sign = (header & 1 ? -1 : 1);
+    limbs = reader.take(length);
+
+    if ((length && !limbs[length - 1]) || (!length && sign < 0)) throw std::runtime_error("binary: malformed bigint");
+}
+
+const word* bigint_view::data() const {
+    return limbs;
+}
+
+std::size_t bigint_view::size() const {
+    return length;
+}
+
+int bigint_view::_sign() const {
+    return sign;
+}
+
+bigint bigint_view::to_bigint() const {
+    bigint result;
+
+    result._limbs() = limb_buffer(limbs, limbs + length);
+    result._sign() = sign;
+
+    return result;
+}
+
+//! bigint
+
+void write_binary(binary_writer& writer, const bigint& value) {
+    writer.put(static_cast<word>(value._limbs().size()) << 1 | (value._sign() < 0));
+    writer.put(value._limbs().data(), value._limbs().size());
+}
+
+void read_binary(binary_reader& reader, bigint& value) {
+    value = bigint_view(reader).to_bigint();
+}
+
+void skip_binary(binary_reader& reader, binary_tag<bigint>) {
+    reader.take(reader.get() >> 1);
+}
@@ -0,0 +1,168 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+class bigint;
+
+//! Compact binary format for bigint, fraction, number_field and polynomial values.
+//!
+//! A file is a header (magic word, format version) followed by records, all made of
+//! 64-bit little-endian words, so limb arrays inside a memory-mapped file are aligned
+//! and can be used in place:
+//!
+//!     built-in integer  one word, two's complement
+//!     bigint            size << 1 | negative, then size limbs, least significant first
+//!     fraction<T>       numerator, denominator
+//!     number_field<p>   one word, the residue in [0, p)
+//!     polynomial<T>     coefficient count, then the coefficients from degree 0 up
+//!
+//! Writing goes through a binary_writer over any std::ostream, reading through a
+//! binary_reader over words in memory, typically those of a mapped_file:
+//!
+//!     mapped_file file("table.bin");
+//!     binary_reader reader = file.reader();
+//!     polynomial_view<bigint> table(reader);  // no limb is copied
+//!     binary_reader record = table.coefficient(5);
+//!     bigint_view c(record);
+//!
+//! Every type has write_binary, read_binary and skip_binary overloads, found by
+//! argument-dependent lookup, so nested types such as polynomial<fraction<bigint>> work.
+//! Those of the templates are in Fractions_binary.h, Number_field_binary.h and
+//! Polynomial_binary.h (with polynomial_view), so only code that serializes includes them.
+//! Malformed or truncated data throws std::runtime_error
+
+constexpr std::uint64_t binary_magic = 0x4e4942534854414d; // "MATHSBIN" in little endian
+constexpr std::uint64_t binary_version = 1;
+
+class binary_writer {
+public:
+    using word = std::uint64_t;
+private:
+    std::ostream& stream;
+public:
+    //! Rule of five
+    //! Writes the header
+    explicit binary_writer(std::ostream& stream);
+    binary_writer(const binary_writer& other) = delete;
+    ~binary_writer() = default;
+
+    binary_writer& operator=(const binary_writer& other) = delete;
+
+    //! Methods
+
+    void put(word value);
+    void put(const word* values, std::size_t count);
+};
+
+//! Cursor over serialized words, which must outlive it and everything viewed through it
+class binary_reader {
+public:
+    using word = std::uint64_t;
+private:
+    const word* position;
+    const word* end;
+public:
+    //! Rule of five
+    binary_reader(const word* first, const word* last);
+
+    //! Methods
+
+    //! Consumes the header, throws if it is missing or of a newer version
+    void expect_header();
+
+    word get();
+
+    //! Consumes count words and returns where they start
+    const word* take(std::size_t count);
+
+    const word* current() const;
+    std::size_t remaining() const;
+};
+
+//! Read-only memory map of a whole file, the reader starts after the header
+class mapped_file {
+public:
+    using word = std::uint64_t;
+private:
+    const word* words;
+    std::size_t length; // in words
+    std::size_t bytes;
+    void* handle; // the mapping object on Windows, unused elsewhere
+public:
+    //! Rule of five
+    explicit mapped_file(const std::string& path);
+    mapped_file(const mapped_file& other) = delete;
+    mapped_file(mapped_file&& other) noexcept;
+    ~mapped_file();
+
+    mapped_file& operator=(const mapped_file& other) = delete;
+
+    //! Methods
+
+    const word* data() const;
+    std::size_t size() const;
+
+    binary_reader reader() const;
+};
+
+//! A bigint record in place: the limbs stay in the reader's memory
+class bigint_view {
+public:
+    using word = std::uint64_t;
+private:
+    const word* limbs;
+    std::size_t length;
+    int sign;
+public:
+    //! Rule of five
+    //! Consumes a bigint record
+    explicit bigint_view(binary_reader& reader);
+
+    //! Methods
+
+    const word* data() const;
+    std::size_t size() const;
+    int _sign() const;
+
+    bigint to_bigint() const;
+};
+
+//! Selects the skip_binary overload, which passes over a record without reading it
+template<typename T>
+struct binary_tag {};
+
+void write_binary(binary_writer& writer, const bigint& value);
+void read_binary(binary_reader& reader, bigint& value);
+void skip_binary(binary_reader& reader, binary_tag<bigint>);
+
+//! Built-in integers
+
+template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+void write_binary(binary_writer& writer, I value) {
+    writer.put(static_cast<binary_writer::word>(value));
+}
+
+//! The word must be a value of I, as written from I or a narrower type of the same signedness
+template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+void read_binary(binary_reader& reader, I& value) {
+    binary_reader::word word = reader.get();
+    I result = static_cast<I>(word);
+
+    // Signed values were sign extended, so those in range come back unchanged
+    if (static_cast<binary_reader::word>(result) != word) throw std::runtime_error("binary: integer out of range");
+
+    value = result;
+}
+
+template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+void skip_binary(binary_reader& reader, binary_tag<I>) {
+    reader.take(1);
+}
+
+#endif // BINARY_H
@@ -0,0 +1,183 @@
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include "Bigint.h"
+#include "Binary.h"
+#include "../Fractions/Fractions.h"
+#include "../Fractions/Fractions.cpp"
+#include "../Fractions/Fractions_binary.h"
+#include "../Fractions/Fractions_binary.cpp"
+#include "../Number field of prime order/Number_field.h"
+#include "../Number field of prime order/Number_field.cpp"
+#include "../Number field of prime order/Number_field_binary.h"
+#include "../Number field of prime order/Number_field_binary.cpp"
+#include "../../Polynomials/Polynomial.cpp"
+#include "../../Polynomials/Polynomial_binary.h"
+#include "../../Polynomials/Polynomial_binary.cpp"
+
+using field = number_field<998244353>;
+
+const char* path = "binary_test.bin";
+
+//! A random integer of at most bits bits, with a random sign
+bigint random_bigint(std::mt19937_64& random, std::size_t bits) {
+    bigint result = 0;
+
+    for (std::size_t i = 0; i < bits; i += 32) result = result * bigint(std::uint64_t(1) << 32) + bigint(random() >> 32);
+    if (random() % 2) result = -result;
+
+    return result;
+}
+
+struct records {
+    std::int64_t integer;
+    std::vector<bigint> numbers;
+    fraction<bigint> ratio;
+    polynomial<field> residues;
+    polynomial<bigint> coefficients;
+};
+
+records random_records() {
+    std::mt19937_64 random(15);
+    records result{-12345, {bigint(0), bigint(-1)}, fraction<bigint>(), polynomial<field>(field(0)), polynomial<bigint>(bigint(0))};
+
+    for (std::size_t bits : {64, 100, 3000}) result.numbers.push_back(random_bigint(random, bits));
+    result.ratio = fraction<bigint>(random_bigint(random, 500), random_bigint(random, 300) * bigint(6));
+
+    result.residues.coef().resize(50);
+    for (auto& x : result.residues.coef()) x = field(random() % 998244353);
+
+    result.coefficients.coef().resize(20);
+    for (std::size_t i = 0; i < 20; i++) result.coefficients[i] = random_bigint(random, 64 * i + 1);
+
+    return result;
+}
+
+void write_records(const records& value) {
+    std::ofstream file(path, std::ios::binary);
+    binary_writer writer(file);
+
+    write_binary(writer, value.integer);
+    for (const bigint& x : value.numbers) write_binary(writer, x);
+    write_binary(writer, value.ratio);
+    write_binary(writer, value.residues);
+    write_binary(writer, value.coefficients);
+}
+
+//! Everything read back, once by copying and once in place
+bool check_round_trip(const records& value) {
+    mapped_file file(path);
+    binary_reader reader = file.reader();
+
+    std::int64_t integer;
+    read_binary(reader, integer);
+    bool result = (integer == value.integer);
+
+    for (const bigint& x : value.numbers) {
+        binary_reader before = reader;
+        bigint copy;
+        read_binary(reader, copy);
+
+        bigint_view view(before);
+        result &= (copy == x && view.to_bigint() == x && view.data() + view.size() == reader.current());
+    }
+
+    fraction<bigint> ratio;
+    read_binary(reader, ratio);
+    result &= (ratio.num() == value.ratio.num() && ratio.denom() == value.ratio.denom());
+
+    binary_reader view_reader = reader;
+    polynomial<field> residues(field(0));
+    read_binary(reader, residues);
+    polynomial_view<field> residues_view(view_reader);
+    result &= (residues == value.residues && residues_view.to_polynomial() == value.residues);
+
+    view_reader = reader;
+    polynomial<bigint> coefficients(bigint(0));
+    read_binary(reader, coefficients);
+    polynomial_view<bigint> coefficients_view(view_reader);
+    result &= (coefficients == value.coefficients && coefficients_view.size() == value.coefficients.coef().size());
+
+    for (std::size_t i = 0; i < coefficients_view.size(); i++) {
+        binary_reader record = coefficients_view.coefficient(i);
+        result &= (bigint_view(record).to_bigint() == value.coefficients[i] && coefficients_view[i] == value.coefficients[i]);
+    }
+
+    return result && reader.remaining() == 0 && view_reader.remaining() == 0;
+}
+
+//! Whether reading the words as a file throws std::runtime_error
+template<typename Read>
+bool rejects(std::vector<std::uint64_t> words, Read read) {
+    try {
+        binary_reader reader(words.data(), words.data() + words.size());
+        reader.expect_header();
+        read(reader);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+
+    return false;
+}
+
+bool check_malformed() {
+    auto nothing = [](binary_reader&) {};
+    auto integer = [](binary_reader& reader) {
+        int value;
+        read_binary(reader, value);
+    };
+    auto natural = [](binary_reader& reader) {
+        unsigned value;
+        read_binary(reader, value);
+    };
+    auto residue = [](binary_reader& reader) {
+        field value;
+        read_binary(reader, value);
+    };
+    auto number = [](binary_reader& reader) {
+        bigint value;
+        read_binary(reader, value);
+    };
+
+    // Header, values in range
+    bool result = !rejects({binary_magic, binary_version, std::uint64_t(-5)}, integer);
+    result &= !rejects({binary_magic, binary_version, 4294967295u}, natural);
+
+    result &= rejects({binary_magic + 1, binary_version}, nothing);
+    result &= rejects({binary_magic, binary_version + 1}, nothing);
+    result &= rejects({binary_magic}, nothing);
+
+    // Integers that do not fit, a residue of at least p, a truncated and a non-normalized bigint
+    result &= rejects({binary_magic, binary_version, 4294967295u}, integer);
+    result &= rejects({binary_magic, binary_version, std::uint64_t(1) << 40}, integer);
+    result &= rejects({binary_magic, binary_version, std::uint64_t(-1)}, natural);
+    result &= rejects({binary_magic, binary_version, 998244353}, residue);
+    result &= rejects({binary_magic, binary_version, 3 << 1, 1, 2}, number);
+    result &= rejects({binary_magic, binary_version, 2 << 1, 1, 0}, number);
+
+    // A file whose header was damaged
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write("MATHSBIX", 8);
+    }
+
+    try {
+        mapped_file file(path);
+        file.reader();
+        result = false;
+    } catch (const std::runtime_error&) {}
+
+    return result;
+}
+
+int main() {
+    records value = random_records();
+    write_records(value);
+
+    std::cout << "round trip through a mapped file: " << check_round_trip(value) << std::endl;
+    std::cout << "malformed data rejected: " << check_malformed() << std::endl;
+
+    std::remove(path);
+}
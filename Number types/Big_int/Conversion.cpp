@@ -0,0 +1,309 @@
+#include "Bigint.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string_view>
+
+namespace {
+
+using limb = bigint::limb;
+
+constexpr limb decimal_chunk = 10000000000000000000ull; // 10^19, the largest power of ten in a limb
+constexpr std::size_t decimal_chunk_digits = 19;
+
+//! Below these sizes the quadratic chunk-by-chunk conversion is faster than divide and conquer
+constexpr std::size_t to_chars_threshold = 48;                             // limbs
+constexpr std::size_t from_chars_threshold = 48 * decimal_chunk_digits;    // digits
+
+//! Enough 10^19 chunks for any value below to_chars_threshold limbs
+constexpr std::size_t max_small_chunks = to_chars_threshold * 64 / 63 + 1;
+
+//! max_decimal_length of a value of to_chars_threshold limbs, which operator<< writes on the stack
+constexpr std::size_t max_small_length = to_chars_threshold * 64 * 30103 / 100000 + 2;
+
+//! operator>> parses its input in pieces of 19 2^stream_piece_level digits on the stack
+constexpr std::size_t stream_piece_level = 5;
+constexpr std::size_t stream_piece_digits = decimal_chunk_digits << stream_piece_level;
+
+//! 10^(19 2^level), computed once per thread. A deque keeps references stable while it grows.
+//! The powers live on the heap, since they outlive any memory_scope
+const bigint& power_of_ten(std::size_t level) {
+    thread_local std::deque<bigint> powers;
+
+    if (level < powers.size()) return powers[level];
+
+    memory_scope heap(nullptr);
+    while (powers.size() <= level) {
+        if (powers.empty()) {
+            bigint chunk;
+            chunk._limbs().push_back(decimal_chunk);
+            powers.push_back(chunk);
+        }
+        else {
+            powers.push_back(powers.back() * powers.back());
+        }
+    }
+
+    return powers[level];
+}
+
+std::size_t chunk_length(limb chunk) {
+    std::size_t length = 1;
+
+    for (; chunk >= 10; chunk /= 10) length++;
+    return length;
+}
+
+//! Writes exactly width digits of chunk, with leading zeros
+void write_chunk(char* out, limb chunk, std::size_t width) {
+    for (std::size_t i = width; i-- > 0; chunk /= 10) out[i] = static_cast<char>('0' + chunk % 10);
+}
+
+//! Quadratic conversion of the magnitude x[0, n) on the stack. With width == 0 the digits are
+//! written without leading zeros, otherwise exactly width digits are written. Returns nullptr if out of space
+char* write_small(const limb* x, std::size_t n, char* out, char* last, std::size_t width) {
+    limb scratch[to_chars_threshold], chunks[max_small_chunks];
+    std::size_t count = 0;
+
+    std::copy(x, x + n, scratch);
+
+    while (n) {
+        chunks[count++] = limbs::divrem_1(scratch, scratch, n, decimal_chunk);
+        n = limbs::normalized_size(scratch, n);
+    }
+
+    if (!width) {
+        if (!count) chunks[count++] = 0;
+        width = chunk_length(chunks[count - 1]) + (count - 1) * decimal_chunk_digits;
+    }
+
+    if (static_cast<std::size_t>(last - out) < width) return nullptr;
+
+    char* end = out + width;
+    char* position = end;
+
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t length = std::min<std::size_t>(decimal_chunk_digits, position - out);
+
+        position -= length;
+        write_chunk(position, chunks[i], length);
+    }
+
+    std::fill(out, position, '0');
+    return end;
+}
+
+//! Writes exactly 19 2^level digits of x < 10^(19 2^level)
+char* write_padded(const bigint& x, char* out, char* last, std::size_t level) {
+    std::size_t width = decimal_chunk_digits << level;
+
+    if (x._limbs().size() <= to_chars_threshold) return write_small(x._limbs().data(), x._limbs().size(), out, last, width);
+
+    std::pair<bigint, bigint> parts = divmod(x, power_of_ten(level - 1));
+
+    out = write_padded(parts.first, out, last, level - 1);
+    return out ? write_padded(parts.second, out, last, level - 1) : nullptr;
+}
+
+//! The digits of the normalized magnitude x[0, n), which is read in place
+char* write_digits(const limb* x, std::size_t n, char* out, char* last) {
+    if (n <= to_chars_threshold) return write_small(x, n, out, last, 0);
+
+    // Split at the largest cached power whose square still exceeds x
+    std::size_t level = 0;
+    while (limbs::cmp(power_of_ten(level + 1)._limbs().data(), power_of_ten(level + 1)._limbs().size(), x, n) <= 0) level++;
+
+    const limb_buffer& divisor = power_of_ten(level)._limbs();
+    bigint quotient, remainder;
+
+    quotient._limbs().resize(n - divisor.size() + 1);
+    remainder._limbs().resize(divisor.size());
+
+    limbs::divrem(quotient._limbs().data(), remainder._limbs().data(), x, n, divisor.data(), divisor.size());
+
+    quotient.trim_zeros();
+    remainder.trim_zeros();
+
+    out = write_digits(quotient._limbs().data(), quotient._limbs().size(), out, last);
+    return out ? write_padded(remainder, out, last, level) : nullptr;
+}
+
+//! Value of the decimal digits in [first, last)
+bigint parse_digits(const char* first, const char* last) {
+    std::size_t length = last - first;
+
+    if (length > from_chars_threshold) {
+        std::size_t level = 0;
+        while ((decimal_chunk_digits << (level + 1)) < length) level++;
+
+        const char* middle = last - (decimal_chunk_digits << level);
+        return parse_digits(first, middle) * power_of_ten(level) + parse_digits(middle, last);
+    }
+
+    bigint value;
+    limb_buffer& result = value._limbs();
+
+    while (first != last) {
+        std::size_t chunk_size = std::min<std::size_t>(decimal_chunk_digits, last - first);
+        limb chunk = 0, scale = 1;
+
+        for (std::size_t i = 0; i < chunk_size; i++, first++) {
+            chunk = chunk * 10 + (*first - '0');
+            scale *= 10;
+        }
+
+        limb carry = limbs::mul_1(result.data(), result.data(), result.size(), scale);
+        if (carry) result.push_back(carry);
+
+        for (std::size_t k = 0; chunk && k <= result.size(); k++) {
+            if (k == result.size()) result.push_back(0);
+
+            result[k] += chunk;
+            chunk = (result[k] < chunk);
+        }
+    }
+
+    value.trim_zeros();
+    return value;
+}
+
+//! 10^digits, from the cached powers
+bigint power_of_ten_digits(std::size_t digits) {
+    bigint result = 1;
+
+    for (std::size_t level = 0; (decimal_chunk_digits << level) <= digits; level++) {
+        if ((digits / decimal_chunk_digits) >> level & 1) result *= power_of_ten(level);
+    }
+
+    long long small = 1;
+    for (std::size_t i = 0; i < digits % decimal_chunk_digits; i++) small *= 10;
+
+    return result * bigint(small);
+}
+
+} // namespace
+
+std::to_chars_result to_chars(char* first, char* last, const bigint& value) {
+    if (value._sign() == -1) {
+        if (first == last) return {last, std::errc::value_too_large};
+        *first++ = '-';
+    }
+
+    char* end = write_digits(value._limbs().data(), value._limbs().size(), first, last);
+
+    if (!end) return {last, std::errc::value_too_large};
+    return {end, std::errc()};
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, bigint& value) {
+    const char* digits = first;
+    if (digits != last && *digits == '-') digits++;
+
+    const char* end = digits;
+    while (end != last && *end >= '0' && *end <= '9') end++;
+
+    if (end == digits) return {first, std::errc::invalid_argument};
+
+    value = parse_digits(digits, end);
+    if (digits != first && value) value._sign() = -1;
+
+    return {end, std::errc()};
+}
+
+std::size_t max_decimal_length(const bigint& value) {
+    // log10(2) < 0.30103, plus one digit for the rounding and one for the sign
+    return value._limbs().size() * 64 * 30103 / 100000 + 2;
+}
+
+//! Out-of-class non-arithmetic operators
+
+std::istream& operator>>(std::istream& stream, bigint& value) {
+    std::istream::sentry sentry(stream);
+    if (!sentry) return stream;
+
+    using traits = std::istream::traits_type;
+
+    std::streambuf* buffer = stream.rdbuf();
+    traits::int_type c = buffer->sgetc();
+
+    bool negative = traits::eq_int_type(c, traits::to_int_type('-'));
+    if (negative || traits::eq_int_type(c, traits::to_int_type('+'))) c = buffer->snextc();
+
+    // Full pieces are merged like a binary counter: pieces[i] has stream_piece_digits 2^levels[i]
+    // digits, and two of the same length become one, so the work stays that of from_chars
+    std::vector<bigint> pieces;
+    std::vector<std::size_t> levels;
+
+    char digits[stream_piece_digits];
+    std::size_t length = 0, total = 0;
+
+    while (!traits::eq_int_type(c, traits::eof()) && traits::to_char_type(c) >= '0' && traits::to_char_type(c) <= '9') {
+        digits[length++] = traits::to_char_type(c);
+        total++;
+        c = buffer->snextc();
+
+        if (length < stream_piece_digits) continue;
+
+        bigint piece;
+        from_chars(digits, digits + length, piece);
+        length = 0;
+
+        pieces.push_back(std::move(piece));
+        levels.push_back(0);
+
+        while (levels.size() >= 2 && levels[levels.size() - 2] == levels.back()) {
+            std::size_t level = levels.back();
+            bigint low = std::move(pieces.back());
+
+            pieces.pop_back();
+            levels.pop_back();
+
+            pieces.back() = pieces.back() * power_of_ten(stream_piece_level + level) + low;
+            levels.back()++;
+        }
+    }
+
+    std::ios::iostate state = std::ios::goodbit;
+    if (traits::eq_int_type(c, traits::eof())) state |= std::ios::eofbit;
+
+    if (!total) {
+        stream.setstate(state | std::ios::failbit);
+        return stream;
+    }
+
+    // The pieces from the least significant one, with the digits left over below them
+    bigint result;
+    from_chars(digits, digits + length, result);
+
+    std::size_t low_digits = length;
+
+    for (std::size_t i = pieces.size(); i-- > 0;) {
+        result += pieces[i] * power_of_ten_digits(low_digits);
+        low_digits += stream_piece_digits << levels[i];
+    }
+
+    if (negative && result) result._sign() = -1;
+    value = std::move(result);
+
+    stream.setstate(state);
+    return stream;
+}
+
+std::ostream& operator<<(std::ostream& stream, const bigint& value) {
+    char small[max_small_length];
+    std::unique_ptr<char[]> large;
+
+    std::size_t length = max_decimal_length(value);
+    char* first = small;
+
+    if (length > max_small_length) {
+        large.reset(new char[length]);
+        first = large.get();
+    }
+
+    char* end = to_chars(first, first + length, value).ptr;
+
+    // Through a string_view, which honours the width and fill of the stream
+    return stream << std::string_view(first, end - first);
+}
@@ -0,0 +1,294 @@
+#include "Limbs.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace limbs {
+
+namespace {
+
+using buffer = std::vector<limb>;
+
+//! Compares magnitudes that may carry leading zero limbs
+int compare(const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    return cmp(a, normalized_size(a, an), b, normalized_size(b, bn));
+}
+
+void increment(limb* a, std::size_t n) {
+    for (std::size_t i = 0; i < n && !++a[i]; i++) {}
+}
+
+void decrement(limb* a, std::size_t n) {
+    for (std::size_t i = 0; i < n && !a[i]--; i++) {}
+}
+
+//! Splits a into n-limb blocks and divides the running remainder, extended by the next block,
+//! by b. divide_2n1n(q, r, z, b, n) must divide the 2n-limb z < b B^n by the normalized n-limb b
+template<class Divider>
+void divide_blocks(limb* q, std::size_t qn, limb* r, const limb* a, std::size_t an, const limb* b, std::size_t n,
+                   Divider divide_2n1n) {
+    std::size_t blocks = (an + n - 1) / n;
+    buffer padded(a, a + an);
+    padded.resize(blocks * n + n, 0);
+
+    if (blocks < 2 || compare(padded.data() + (blocks - 1) * n, n, b, n) >= 0) blocks++;
+
+    buffer quotient((blocks - 1) * n), remainder(padded.begin() + (blocks - 1) * n, padded.begin() + blocks * n);
+    buffer z(2 * n);
+
+    for (std::size_t i = blocks - 1; i-- > 0;) {
+        std::copy(padded.begin() + i * n, padded.begin() + (i + 1) * n, z.begin());
+        std::copy(remainder.begin(), remainder.end(), z.begin() + n);
+
+        divide_2n1n(quotient.data() + i * n, remainder.data(), z.data(), b, n);
+    }
+
+    std::copy(quotient.begin(), quotient.begin() + qn, q);
+    std::copy(remainder.begin(), remainder.end(), r);
+}
+
+void div_3n2n(limb* q, limb* r, const limb* a, const limb* b, std::size_t k);
+
+//! Burnikel-Ziegler: q[0..n), r[0..n) from the 2n-limb a < b B^n and the normalized n-limb b
+void div_2n1n(limb* q, limb* r, const limb* a, const limb* b, std::size_t n) {
+    if (n % 2 || n < burnikel_ziegler_threshold) {
+        buffer u(a, a + 2 * n), quotient(n + 1);
+        divrem_basecase(quotient.data(), u.data(), 2 * n, b, n);
+
+        std::copy(quotient.begin(), quotient.begin() + n, q);
+        std::copy(u.begin(), u.begin() + n, r);
+        return;
+    }
+
+    std::size_t k = n / 2;
+    buffer middle(3 * k);
+
+    div_3n2n(q + k, middle.data() + k, a + k, b, k);
+    std::copy(a, a + k, middle.begin());
+    div_3n2n(q, r, middle.data(), b, k);
+}
+
+//! q[0..k), r[0..2k) from the 3k-limb a < b B^k and the normalized 2k-limb b
+void div_3n2n(limb* q, limb* r, const limb* a, const limb* b, std::size_t k) {
+    const limb* b0 = b;
+    const limb* b1 = b + k;
+
+    // c = a2 a1 - q b1, evaluated with the quotient estimated from the top halves
+    buffer c(2 * k + 1, 0);
+
+    if (compare(a + 2 * k, k, b1, k) < 0) {
+        div_2n1n(q, c.data(), a + k, b1, k);
+    }
+    else {
+        std::fill(q, q + k, ~limb(0));
+        std::copy(a + k, a + 3 * k, c.begin());
+        sub(c.data() + k, c.data() + k, k, b1, k);
+        add(c.data(), c.data(), 2 * k + 1, b1, k);
+    }
+
+    buffer d(2 * k);
+    mul(d.data(), q, k, b0, k);
+
+    // t = c B^k + a0 - q b0, corrected while it is negative
+    buffer t(3 * k + 2, 0);
+    std::copy(a, a + k, t.begin());
+    std::copy(c.begin(), c.end(), t.begin() + k);
+
+    while (compare(t.data(), t.size(), d.data(), d.size()) < 0) {
+        add(t.data(), t.data(), t.size(), b, 2 * k);
+        decrement(q, k);
+    }
+
+    sub(t.data(), t.data(), t.size(), d.data(), d.size());
+    std::copy(t.begin(), t.begin() + 2 * k, r);
+}
+
+//! Division by a normalized divisor without the Newton path
+void divide_normalized(limb* q, std::size_t qn, limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    if (bn < burnikel_ziegler_threshold || an - bn < burnikel_ziegler_threshold) {
+        buffer u(a, a + an), quotient(an - bn + 1);
+        divrem_basecase(quotient.data(), u.data(), an, b, bn);
+
+        std::copy(quotient.begin(), quotient.begin() + qn, q);
+        std::copy(u.begin(), u.begin() + bn, r);
+        return;
+    }
+
+    // Pad the divisor with low zero limbs to j 2^k limbs, j below the threshold,
+    // so that every recursion level of div_2n1n splits it evenly
+    std::size_t unit = 1;
+    while (bn / unit >= burnikel_ziegler_threshold) unit *= 2;
+
+    std::size_t n = (bn + unit - 1) / unit * unit;
+    std::size_t pad = n - bn;
+
+    buffer padded_b(pad, 0), padded_a(pad, 0), remainder(n);
+    padded_b.insert(padded_b.end(), b, b + bn);
+    padded_a.insert(padded_a.end(), a, a + an);
+
+    divide_blocks(q, qn, remainder.data(), padded_a.data(), padded_a.size(), padded_b.data(), n, div_2n1n);
+    std::copy(remainder.begin() + pad, remainder.end(), r);
+}
+
+//! v[0..n + 1) approximates floor(B^2n / d) within a few units for a normalized n-limb d,
+//! by Newton iteration with precision doubling
+void reciprocal(limb* v, const limb* d, std::size_t n) {
+    if (n < newton_division_threshold) {
+        buffer power(2 * n + 1, 0), remainder(n);
+        power.back() = 1;
+
+        divide_normalized(v, n + 1, remainder.data(), power.data(), power.size(), d, n);
+        return;
+    }
+
+    // y = floor(B^2h / d_high) gives x = y B^(n - h) ~ B^2n / d to about h limbs
+    std::size_t h = (n + 1) / 2;
+    buffer y(h + 1);
+    reciprocal(y.data(), d + (n - h), h);
+
+    // Newton step x += x (B^2n - d x) / B^2n, where B^2n - d x = B^(n - h) e
+    // with e = B^(n + h) - d y of about n limbs
+    buffer e(n + h + 2, 0);
+    mul(e.data(), d, n, y.data(), h + 1);
+    e[n + h + 1] = 0;
+
+    buffer power(n + h + 2, 0);
+    power[n + h] = 1;
+    bool negative = sub_n(e.data(), power.data(), e.data(), e.size());
+
+    if (negative) {
+        std::fill(power.begin(), power.end(), 0);
+        sub_n(e.data(), power.data(), e.data(), e.size());
+    }
+
+    // Only the top h + 2 limbs of e contribute to the integer part of the correction
+    std::size_t skip = n - h - 1;
+    std::size_t top_size = normalized_size(e.data() + skip, e.size() - skip);
+
+    std::fill(v, v + n + 1, 0);
+    std::copy(y.begin(), y.end(), v + (n - h));
+
+    if (!top_size) return;
+
+    buffer correction(h + 1 + top_size);
+    mul(correction.data(), y.data(), h + 1, e.data() + skip, top_size);
+
+    std::size_t shift = 3 * h + 1 - n;
+
+    if (correction.size() > shift) {
+        if (negative) sub(v, v, n + 1, correction.data() + shift, correction.size() - shift);
+        else add(v, v, n + 1, correction.data() + shift, correction.size() - shift);
+    }
+
+    if (negative) decrement(v, n + 1);
+}
+
+//! q[0..n), r[0..n) from the 2n-limb a < b B^n, given v ~ floor(B^2n / b)
+void div_2n1n_newton(limb* q, limb* r, const limb* a, const limb* b, std::size_t n, const buffer& v) {
+    // The top n + 1 limbs of a times v give the quotient up to a few units
+    buffer product(2 * n + 2);
+    mul(product.data(), a + (n - 1), n + 1, v.data(), n + 1);
+
+    buffer estimate(product.begin() + (n + 1), product.end());
+    buffer multiple(2 * n + 1);
+    mul(multiple.data(), b, n, estimate.data(), n + 1);
+
+    buffer remainder(a, a + 2 * n);
+    remainder.push_back(0);
+    limb borrow = sub_n(remainder.data(), remainder.data(), multiple.data(), 2 * n + 1);
+
+    while (borrow) {
+        decrement(estimate.data(), estimate.size());
+        if (add(remainder.data(), remainder.data(), remainder.size(), b, n)) borrow = 0;
+    }
+
+    while (compare(remainder.data(), remainder.size(), b, n) >= 0) {
+        increment(estimate.data(), estimate.size());
+        sub(remainder.data(), remainder.data(), remainder.size(), b, n);
+    }
+
+    std::copy(estimate.begin(), estimate.begin() + n, q);
+    std::copy(remainder.begin(), remainder.begin() + n, r);
+}
+
+} // namespace
+
+void divrem_basecase(limb* q, limb* u, std::size_t un, const limb* d, std::size_t dn) {
+    std::size_t m = un - dn;
+
+    if (dn == 1) {
+        u[0] = divrem_1(q, u, un, d[0]);
+        return;
+    }
+
+    // The top quotient limb is 0 or 1 since the divisor is normalized
+    q[m] = (compare(u + m, dn, d, dn) >= 0);
+    if (q[m]) sub_n(u + m, u + m, d, dn);
+
+    limb d_high = d[dn - 1], d_next = d[dn - 2];
+
+    for (std::size_t j = m; j-- > 0;) {
+        limb top = u[j + dn];
+        limb estimate = ~limb(0);
+
+        if (top < d_high) {
+            dlimb numerator = (static_cast<dlimb>(top) << limb_bits) | u[j + dn - 1];
+            estimate = static_cast<limb>(numerator / d_high);
+            dlimb rest = numerator % d_high;
+
+            while (!(rest >> limb_bits) && static_cast<dlimb>(estimate) * d_next > ((rest << limb_bits) | u[j + dn - 2])) {
+                estimate--;
+                rest += d_high;
+            }
+        }
+
+        // The window is negative until its top limb wraps back to zero
+        top -= submul_1(u + j, d, dn, estimate);
+
+        while (top) {
+            estimate--;
+            top += add_n(u + j, u + j, d, dn);
+        }
+
+        u[j + dn] = 0;
+        q[j] = estimate;
+    }
+}
+
+void divrem(limb* q, limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    if (bn == 1) {
+        r[0] = divrem_1(q, a, an, b[0]);
+        return;
+    }
+
+    // Normalize so that the divisor has its top bit set, the quotient is unchanged
+    int shift = __builtin_clzll(b[bn - 1]);
+    buffer divisor(b, b + bn), dividend(a, a + an);
+    dividend.push_back(0);
+
+    if (shift) {
+        lshift(divisor.data(), b, bn, shift);
+        dividend[an] = lshift(dividend.data(), a, an, shift);
+    }
+
+    buffer remainder(bn);
+
+    if (bn >= newton_division_threshold && an - bn >= newton_division_threshold) {
+        buffer v(bn + 1);
+        reciprocal(v.data(), divisor.data(), bn);
+
+        auto divide_2n1n = [&v](limb* q, limb* r, const limb* a, const limb* b, std::size_t n) {
+            div_2n1n_newton(q, r, a, b, n, v);
+        };
+
+        divide_blocks(q, an - bn + 1, remainder.data(), dividend.data(), dividend.size(), divisor.data(), bn, divide_2n1n);
+    }
+    else {
+        divide_normalized(q, an - bn + 1, remainder.data(), dividend.data(), dividend.size(), divisor.data(), bn);
+    }
+
+    if (shift) rshift(r, remainder.data(), bn, shift);
+    else std::copy(remainder.begin(), remainder.end(), r);
+}
+
+} // namespace limbs
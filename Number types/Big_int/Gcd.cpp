@@ -0,0 +1,343 @@
+#include "Bigint.h"
+
+#include <climits>
+#include <numeric>
+
+namespace {
+
+using limb = bigint::limb;
+
+//! From this many limbs on, gcd goes through the half-gcd recursion instead of Lehmer steps
+constexpr std::size_t gcd_threshold = 1536;
+
+//! Below this many limbs, the half-gcd recursion bottoms out in Lehmer steps
+constexpr std::size_t half_gcd_threshold = 128;
+
+//! Unimodular matrix m with (a; b) = m (a'; b') between an original pair and the pair
+//! it was reduced to. det is the determinant, +-1
+struct cofactors {
+    bigint m00 = 1, m01 = 0, m10 = 0, m11 = 1;
+    int det = 1;
+};
+
+//! x y
+cofactors product(const cofactors& x, const cofactors& y) {
+    cofactors result;
+
+    result.m00 = x.m00 * y.m00 + x.m01 * y.m10;
+    result.m01 = x.m00 * y.m01 + x.m01 * y.m11;
+    result.m10 = x.m10 * y.m00 + x.m11 * y.m10;
+    result.m11 = x.m10 * y.m01 + x.m11 * y.m11;
+    result.det = x.det * y.det;
+
+    return result;
+}
+
+bool is_identity(const cofactors& m) {
+    return !m.m01 && !m.m10 && m.m00 == 1 && m.m11 == 1;
+}
+
+std::size_t bit_length(const bigint& x) {
+    const limb_buffer& digits = x._limbs();
+    return digits.empty() ? 0 : digits.size() * limbs::limb_bits - __builtin_clzll(digits.back());
+}
+
+//! x >> bits for x >= 0
+bigint shift_down(const bigint& x, std::size_t bits) {
+    const limb_buffer& digits = x._limbs();
+    std::size_t skip = bits / limbs::limb_bits;
+    int shift = bits % limbs::limb_bits;
+
+    bigint result;
+    if (skip >= digits.size()) return result;
+
+    limb_buffer& r = result._limbs();
+    r = limb_buffer(digits.begin() + skip, digits.end());
+    if (shift) limbs::rshift(r.data(), r.data(), r.size(), shift);
+
+    result.trim_zeros();
+    return result;
+}
+
+//! The 62 bits of x from bit shift up, x must be below 2^(shift + 62)
+long long leading_bits(const bigint& x, std::size_t shift) {
+    const limb_buffer& digits = x._limbs();
+    std::size_t index = shift / limbs::limb_bits;
+    int offset = shift % limbs::limb_bits;
+
+    if (index >= digits.size()) return 0;
+
+    limb value = digits[index] >> offset;
+    if (offset && index + 1 < digits.size()) value |= digits[index + 1] << (limbs::limb_bits - offset);
+
+    return static_cast<long long>(value);
+}
+
+//! x a + y b for coefficients of opposite signs (or zero) whose result is known to be nonnegative
+bigint combine(const bigint& a, long long x, const bigint& b, long long y) {
+    bool a_positive = (x >= 0 && y <= 0);
+
+    const limb_buffer& p = (a_positive ? a : b)._limbs();
+    const limb_buffer& q = (a_positive ? b : a)._limbs();
+    limb pc = static_cast<limb>(a_positive ? x : y);
+    limb qc = 0 - static_cast<limb>(a_positive ? y : x);
+
+    bigint result;
+    limb_buffer& r = result._limbs();
+    std::size_t n = std::max(p.size(), q.size()) + 1;
+
+    r.resize(n);
+    r[p.size()] = limbs::mul_1(r.data(), p.data(), p.size(), pc);
+
+    limb borrow = limbs::submul_1(r.data(), q.data(), q.size(), qc);
+    for (std::size_t i = q.size(); borrow && i < n; i++) {
+        limb current = r[i];
+        r[i] = current - borrow;
+        borrow = (current < borrow);
+    }
+
+    result.trim_zeros();
+    return result;
+}
+
+//! (a, b) -> (b, a mod b)
+void euclid_step(bigint& a, bigint& b, cofactors* m) {
+    std::pair<bigint, bigint> parts = divmod(a, b);
+
+    a = std::move(b);
+    b = std::move(parts.second);
+
+    if (!m) return;
+
+    // m [[q, 1], [1, 0]]
+    bigint column = m->m00 * parts.first + m->m01;
+    m->m01 = std::move(m->m00);
+    m->m00 = std::move(column);
+
+    column = m->m10 * parts.first + m->m11;
+    m->m11 = std::move(m->m10);
+    m->m10 = std::move(column);
+
+    m->det = -m->det;
+}
+
+//! Lehmer's step (Knuth's algorithm L): runs Euclid on the leading 62 bits of a >= b > 0 for as
+//! long as both quotient bounds agree, then applies all those quotients at once. Stops before
+//! the remainders would fall below 2^floor_bits. Returns false if no quotient could be settled
+bool lehmer_step(bigint& a, bigint& b, cofactors* m, std::size_t floor_bits) {
+    std::size_t n = bit_length(a), shift = (n > 62 ? n - 62 : 0);
+    long long u = leading_bits(a, shift), v = leading_bits(b, shift);
+
+    long long floor = 0;
+    if (floor_bits > shift) floor = (floor_bits - shift >= 62 ? LLONG_MAX : 1LL << (floor_bits - shift));
+
+    long long A = 1, B = 0, C = 0, D = 1;
+    int det = 1;
+
+    while (v + C != 0 && v + D != 0) {
+        long long q = (u + A) / (v + C);
+        if (q != (u + B) / (v + D)) break;
+
+        long long next = u - q * v;
+        if (next < floor) break;
+
+        long long t = A - q * C;
+        A = C;
+        C = t;
+
+        t = B - q * D;
+        B = D;
+        D = t;
+
+        u = v;
+        v = next;
+        det = -det;
+    }
+
+    if (B == 0) return false;
+
+    bigint next_a = combine(a, A, b, B), next_b = combine(a, C, b, D);
+    a = std::move(next_a);
+    b = std::move(next_b);
+
+    if (m) {
+        // m [[A, B], [C, D]]^-1 = det m [[D, -B], [-C, A]]
+        bigint n00 = m->m00 * D - m->m01 * C, n01 = m->m01 * A - m->m00 * B;
+        bigint n10 = m->m10 * D - m->m11 * C, n11 = m->m11 * A - m->m10 * B;
+
+        if (det < 0) {
+            n00 = -std::move(n00);
+            n01 = -std::move(n01);
+            n10 = -std::move(n10);
+            n11 = -std::move(n11);
+        }
+
+        m->m00 = std::move(n00);
+        m->m01 = std::move(n01);
+        m->m10 = std::move(n10);
+        m->m11 = std::move(n11);
+        m->det *= det;
+    }
+
+    return true;
+}
+
+//! Euclid and Lehmer steps until b < 2^target_bits
+void reduce_below(bigint& a, bigint& b, std::size_t target_bits, cofactors* m) {
+    while (bit_length(b) > target_bits) {
+        if (!m && a._limbs().size() == 1) {
+            a = static_cast<long long>(std::gcd(a._limbs()[0], b._limbs()[0]));
+            b = 0;
+            return;
+        }
+
+        if (a._limbs().size() > b._limbs().size() + 1 || !lehmer_step(a, b, m, target_bits)) euclid_step(a, b, m);
+    }
+}
+
+//! (a; b) = m (a'; b') solved for (a', b'), made nonnegative and ordered by adjusting m.
+//! Whatever m is, the new pair keeps the gcd of the old one
+void apply_inverse(bigint& a, bigint& b, cofactors& m) {
+    // m^-1 = det [[m11, -m01], [-m10, m00]]
+    bigint next_a = m.m11 * a - m.m01 * b;
+    bigint next_b = m.m00 * b - m.m10 * a;
+
+    if (m.det < 0) {
+        next_a = -std::move(next_a);
+        next_b = -std::move(next_b);
+    }
+
+    if (next_a._sign() < 0) {
+        next_a = -std::move(next_a);
+        m.m00 = -std::move(m.m00);
+        m.m10 = -std::move(m.m10);
+        m.det = -m.det;
+    }
+
+    if (next_b._sign() < 0) {
+        next_b = -std::move(next_b);
+        m.m01 = -std::move(m.m01);
+        m.m11 = -std::move(m.m11);
+        m.det = -m.det;
+    }
+
+    if (next_a < next_b) {
+        std::swap(next_a, next_b);
+        std::swap(m.m00, m.m01);
+        std::swap(m.m10, m.m11);
+        m.det = -m.det;
+    }
+
+    a = std::move(next_a);
+    b = std::move(next_b);
+}
+
+//! Reduces a >= b >= 0 of n bits until b < 2^(n/2 + 1), in O(M(n) log n). The matrix is found
+//! from the leading halves: the leading n/2 bits reduced to n/4 bits bring the whole pair to
+//! 3n/4 bits, and a second recursion on the leading part of that finishes the job
+cofactors half_gcd(bigint& a, bigint& b) {
+    std::size_t n = bit_length(a), target = n / 2 + 1;
+    cofactors m;
+
+    if (bit_length(b) <= target) return m;
+
+    if (a._limbs().size() < half_gcd_threshold) {
+        reduce_below(a, b, target, &m);
+        return m;
+    }
+
+    std::size_t split = n / 2;
+    bigint high_a = shift_down(a, split), high_b = shift_down(b, split);
+
+    m = half_gcd(high_a, high_b);
+    apply_inverse(a, b, m);
+
+    if (bit_length(b) <= target) return m;
+    euclid_step(a, b, &m);
+    if (bit_length(b) <= target) return m;
+
+    std::size_t length = bit_length(a);
+    split = (2 * target > length ? 2 * target - length : 0);
+    high_a = shift_down(a, split);
+    high_b = shift_down(b, split);
+
+    cofactors second = half_gcd(high_a, high_b);
+    apply_inverse(a, b, second);
+    m = product(m, second);
+
+    reduce_below(a, b, target, &m);
+    return m;
+}
+
+//! Reduces a >= b >= 0 to (gcd, 0), accumulating the steps into m if given
+void reduce_to_gcd(bigint& a, bigint& b, cofactors* m) {
+    while (b._limbs().size() >= gcd_threshold) {
+        if (a._limbs().size() > b._limbs().size() + 1) {
+            euclid_step(a, b, m);
+            continue;
+        }
+
+        // The half-gcd of the leading two thirds takes a third off both numbers
+        std::size_t split = bit_length(a) / 3;
+        bigint high_a = shift_down(a, split), high_b = shift_down(b, split);
+
+        cofactors step = half_gcd(high_a, high_b);
+
+        if (is_identity(step)) {
+            euclid_step(a, b, m);
+            continue;
+        }
+
+        apply_inverse(a, b, step);
+        if (m) *m = product(*m, step);
+    }
+
+    reduce_below(a, b, 0, m);
+}
+
+} // namespace
+
+bigint gcd(const bigint& self, const bigint& other) {
+    bigint a = self.abs(), b = other.abs();
+    if (a < b) std::swap(a, b);
+
+    reduce_to_gcd(a, b, nullptr);
+    return a;
+}
+
+bigint lcm(const bigint& self, const bigint& other) {
+    if (!self || !other) return bigint();
+
+    return self.abs() / gcd(self, other) * other.abs();
+}
+
+std::tuple<bigint, bigint, bigint> xgcd(const bigint& self, const bigint& other) {
+    bigint a = self.abs(), b = other.abs();
+    bool swapped = (a < b);
+    if (swapped) std::swap(a, b);
+
+    if (!a) return {bigint(), bigint(), bigint()};
+
+    // With (a0; b0) = m (g; 0), g = det (m11 a0 - m01 b0)
+    cofactors m;
+    reduce_to_gcd(a, b, &m);
+
+    bigint g = std::move(a);
+    bigint x = (m.det > 0 ? m.m11 : -m.m11), y = (m.det > 0 ? -m.m01 : m.m01);
+
+    if (swapped) std::swap(x, y);
+    if (self._sign() < 0) x = -std::move(x);
+    if (other._sign() < 0) y = -std::move(y);
+
+    if (!other) return {g, x, y};
+
+    // The smallest x of the class x + k other / g, and the y that goes with it
+    bigint period = other.abs() / g;
+    x %= period;
+
+    bigint doubled = x.abs() * 2;
+    if (doubled > period) x -= (x._sign() > 0 ? period : -period);
+
+    y = (g - self * x) / other;
+    return {g, x, y};
+}
@@ -0,0 +1,262 @@
+#include "Limb_buffer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+using limb = limb_buffer::limb;
+
+//! Heap blocks freed recently by this thread. Short-lived temporaries, such as the product
+//! in acc += x * y, take their storage from here, so such loops stop allocating once warm
+constexpr std::size_t cached_blocks = 8;
+constexpr std::size_t max_cached_limbs = 1 << 16;
+
+struct block_cache {
+    limb* blocks[cached_blocks];
+    std::size_t capacities[cached_blocks];
+    std::size_t count;
+    bool closed;
+};
+
+//! Plain data, so it stays usable while other thread_local objects are destroyed
+thread_local block_cache cache;
+thread_local allocation_stats heap;
+
+//! Frees the cached blocks at thread exit, later releases go straight to the heap
+struct block_cache_cleaner {
+    ~block_cache_cleaner() {
+        for (std::size_t i = 0; i < cache.count; i++) delete[] cache.blocks[i];
+
+        cache.count = 0;
+        cache.closed = true;
+    }
+};
+
+//! Block of at least capacity limbs, the actual size is stored into capacity
+limb* allocate(std::pmr::memory_resource* resource, std::size_t& capacity) {
+    if (resource) return static_cast<limb*>(resource->allocate(capacity * sizeof(limb), alignof(limb)));
+
+    thread_local block_cache_cleaner cleaner;
+    (void) cleaner;
+
+    for (std::size_t i = cache.count; i-- > 0;) {
+        if (cache.capacities[i] < capacity || cache.capacities[i] > 2 * capacity) continue;
+
+        limb* block = cache.blocks[i];
+        capacity = cache.capacities[i];
+
+        cache.count--;
+        cache.blocks[i] = cache.blocks[cache.count];
+        cache.capacities[i] = cache.capacities[cache.count];
+
+        heap.on_allocate(capacity * sizeof(limb));
+        return block;
+    }
+
+    heap.on_allocate(capacity * sizeof(limb));
+    heap.system_allocations++;
+
+    return new limb[capacity];
+}
+
+void release(std::pmr::memory_resource* resource, limb* block, std::size_t capacity) {
+    if (resource) {
+        resource->deallocate(block, capacity * sizeof(limb), alignof(limb));
+        return;
+    }
+
+    heap.on_deallocate(capacity * sizeof(limb));
+
+    if (cache.closed || capacity > max_cached_limbs) {
+        delete[] block;
+        return;
+    }
+
+    // Evicts the oldest block when full
+    if (cache.count == cached_blocks) {
+        delete[] cache.blocks[0];
+
+        std::copy(cache.blocks + 1, cache.blocks + cached_blocks, cache.blocks);
+        std::copy(cache.capacities + 1, cache.capacities + cached_blocks, cache.capacities);
+        cache.count--;
+    }
+
+    cache.blocks[cache.count] = block;
+    cache.capacities[cache.count] = capacity;
+    cache.count++;
+}
+
+} // namespace
+
+//! Rule of five
+
+limb_buffer::limb_buffer(): pointer(local), length(0), allocated(inline_capacity), resource(current_resource()) {}
+
+limb_buffer::limb_buffer(std::size_t size, limb value): limb_buffer() {
+    resize(size, value);
+}
+
+limb_buffer::limb_buffer(const limb* first, const limb* last): limb_buffer() {
+    reserve(last - first);
+    std::copy(first, last, pointer);
+    length = last - first;
+}
+
+limb_buffer::limb_buffer(const limb_buffer& other): limb_buffer(other.begin(), other.end()) {}
+
+limb_buffer::limb_buffer(limb_buffer&& other) noexcept:
+    pointer(local), length(0), allocated(inline_capacity), resource(other.resource) {
+    *this = std::move(other);
+}
+
+limb_buffer::~limb_buffer() {
+    free_block();
+}
+
+limb_buffer& limb_buffer::operator=(const limb_buffer& other) {
+    if (this == &other) return *this;
+
+    reserve(other.length);
+    std::copy(other.begin(), other.end(), pointer);
+    length = other.length;
+
+    return *this;
+}
+
+limb_buffer& limb_buffer::operator=(limb_buffer&& other) noexcept {
+    if (this == &other) return *this;
+
+    if (other.is_inline()) {
+        // Never shrinks into the inline buffer, so this always fits
+        std::copy(other.begin(), other.end(), pointer);
+        length = other.length;
+    }
+    else if (resource != other.resource) {
+        // A block from another resource may not live as long as this buffer
+        reserve(other.length);
+        std::copy(other.begin(), other.end(), pointer);
+        length = other.length;
+    }
+    else {
+        free_block();
+
+        pointer = other.pointer;
+        length = other.length;
+        allocated = other.allocated;
+
+        other.pointer = other.local;
+        other.allocated = inline_capacity;
+    }
+
+    other.length = 0;
+    return *this;
+}
+
+//! Methods
+
+bool limb_buffer::is_inline() const {
+    return pointer == local;
+}
+
+void limb_buffer::free_block() {
+    if (!is_inline()) release(resource, pointer, allocated);
+}
+
+void limb_buffer::grow(std::size_t capacity) {
+    limb* memory = allocate(resource, capacity);
+    std::copy(begin(), end(), memory);
+
+    free_block();
+
+    pointer = memory;
+    allocated = capacity;
+}
+
+std::size_t limb_buffer::size() const {
+    return length;
+}
+
+std::size_t limb_buffer::capacity() const {
+    return allocated;
+}
+
+bool limb_buffer::empty() const {
+    return length == 0;
+}
+
+limb_buffer::limb* limb_buffer::data() {
+    return pointer;
+}
+
+const limb_buffer::limb* limb_buffer::data() const {
+    return pointer;
+}
+
+limb_buffer::limb* limb_buffer::begin() {
+    return pointer;
+}
+
+limb_buffer::limb* limb_buffer::end() {
+    return pointer + length;
+}
+
+const limb_buffer::limb* limb_buffer::begin() const {
+    return pointer;
+}
+
+const limb_buffer::limb* limb_buffer::end() const {
+    return pointer + length;
+}
+
+limb_buffer::limb& limb_buffer::operator[](std::size_t index) {
+    return pointer[index];
+}
+
+const limb_buffer::limb& limb_buffer::operator[](std::size_t index) const {
+    return pointer[index];
+}
+
+limb_buffer::limb& limb_buffer::back() {
+    return pointer[length - 1];
+}
+
+const limb_buffer::limb& limb_buffer::back() const {
+    return pointer[length - 1];
+}
+
+void limb_buffer::reserve(std::size_t capacity) {
+    if (capacity > allocated) grow(std::max(capacity, 2 * allocated));
+}
+
+void limb_buffer::resize(std::size_t size, limb value) {
+    reserve(size);
+
+    if (size > length) std::fill(pointer + length, pointer + size, value);
+    length = size;
+}
+
+void limb_buffer::clear() {
+    length = 0;
+}
+
+void limb_buffer::push_back(limb value) {
+    reserve(length + 1);
+    pointer[length++] = value;
+}
+
+void limb_buffer::pop_back() {
+    length--;
+}
+
+bool limb_buffer::operator==(const limb_buffer& other) const {
+    return length == other.length && std::equal(begin(), end(), other.begin());
+}
+
+bool limb_buffer::operator!=(const limb_buffer& other) const {
+    return !(*this == other);
+}
+
+const allocation_stats& limb_buffer::heap_stats() {
+    return heap;
+}
@@ -0,0 +1,77 @@
+#ifndef LIMB_BUFFER_H
+#define LIMB_BUFFER_H
+
+#include <cstddef>
+
+#include "Arena.h"
+#include "Limbs.h"
+
+//! Growable limb array with a small inline buffer, so that values of up to
+//! inline_capacity limbs never touch the heap. Offers the subset of the
+//! std::vector interface that bigint needs.
+//! Larger blocks come from the memory_scope that was current when the buffer was
+//! created, or from the heap. Like the std::pmr containers, moves take the
+//! resource along and assignments keep the destination's one
+class limb_buffer {
+public:
+    using limb = limbs::limb;
+
+    static constexpr std::size_t inline_capacity = 2;
+private:
+    limb* pointer;
+    std::size_t length;
+    std::size_t allocated;
+    limb local[inline_capacity];
+    std::pmr::memory_resource* resource; // nullptr for the heap
+
+    bool is_inline() const;
+    void grow(std::size_t capacity);
+    void free_block();
+public:
+    //! Rule of five
+    limb_buffer();
+    explicit limb_buffer(std::size_t size, limb value = 0);
+    limb_buffer(const limb* first, const limb* last);
+    limb_buffer(const limb_buffer& other);
+    limb_buffer(limb_buffer&& other) noexcept;
+    ~limb_buffer();
+
+    limb_buffer& operator=(const limb_buffer& other);
+    limb_buffer& operator=(limb_buffer&& other) noexcept;
+
+    //! Methods
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+    bool empty() const;
+
+    limb* data();
+    const limb* data() const;
+
+    limb* begin();
+    limb* end();
+    const limb* begin() const;
+    const limb* end() const;
+
+    limb& operator[](std::size_t index);
+    const limb& operator[](std::size_t index) const;
+
+    limb& back();
+    const limb& back() const;
+
+    void reserve(std::size_t capacity);
+    void resize(std::size_t size, limb value = 0);
+    void clear();
+
+    void push_back(limb value);
+    void pop_back();
+
+    bool operator==(const limb_buffer& other) const;
+    bool operator!=(const limb_buffer& other) const;
+
+    //! Heap blocks taken by the buffers of the current thread, system_allocations
+    //! counts the ones not served from the cache of recently freed blocks
+    static const allocation_stats& heap_stats();
+};
+
+#endif // LIMB_BUFFER_H
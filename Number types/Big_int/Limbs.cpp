@@ -0,0 +1,464 @@
+#include "Limbs.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define LIMBS_X86_64
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_addcll) && __has_builtin(__builtin_subcll)
+#define LIMBS_BUILTIN_CARRY
+#endif
+#endif
+
+namespace limbs {
+
+namespace {
+
+//! a + b + carry with the carry flag of the CPU, carry is 0 or 1 on both ends
+inline limb add_carry(limb a, limb b, unsigned char& carry) {
+#if defined(LIMBS_X86_64)
+    unsigned long long sum;
+    carry = _addcarry_u64(carry, a, b, &sum);
+    return sum;
+#elif defined(LIMBS_BUILTIN_CARRY)
+    unsigned long long out;
+    limb sum = __builtin_addcll(a, b, carry, &out);
+    carry = static_cast<unsigned char>(out);
+    return sum;
+#else
+    limb sum = a + carry;
+    unsigned char next = (sum < carry);
+    sum += b;
+    carry = next + (sum < b);
+    return sum;
+#endif
+}
+
+//! a - b - borrow, borrow is 0 or 1 on both ends
+inline limb sub_borrow(limb a, limb b, unsigned char& borrow) {
+#if defined(LIMBS_X86_64)
+    unsigned long long diff;
+    borrow = _subborrow_u64(borrow, a, b, &diff);
+    return diff;
+#elif defined(LIMBS_BUILTIN_CARRY)
+    unsigned long long out;
+    limb diff = __builtin_subcll(a, b, borrow, &out);
+    borrow = static_cast<unsigned char>(out);
+    return diff;
+#else
+    limb diff = a - b;
+    unsigned char next = (a < b);
+    limb result = diff - borrow;
+    borrow = next + (diff < borrow);
+    return result;
+#endif
+}
+
+//! Portable word kernels. They start from a given carry, so the assembly kernels
+//! below reuse them for the limbs left over by their unrolled loops
+
+inline limb mul_1_loop(limb* r, const limb* a, std::size_t n, limb b, limb carry) {
+    for (std::size_t i = 0; i < n; i++) {
+        dlimb prod = static_cast<dlimb>(a[i]) * b + carry;
+        r[i] = static_cast<limb>(prod);
+        carry = static_cast<limb>(prod >> limb_bits);
+    }
+
+    return carry;
+}
+
+inline limb addmul_1_loop(limb* r, const limb* a, std::size_t n, limb b, limb carry) {
+    for (std::size_t i = 0; i < n; i++) {
+        dlimb prod = static_cast<dlimb>(a[i]) * b + r[i] + carry;
+        r[i] = static_cast<limb>(prod);
+        carry = static_cast<limb>(prod >> limb_bits);
+    }
+
+    return carry;
+}
+
+inline limb submul_1_loop(limb* r, const limb* a, std::size_t n, limb b, limb borrow) {
+    for (std::size_t i = 0; i < n; i++) {
+        dlimb prod = static_cast<dlimb>(a[i]) * b + borrow;
+        limb low = static_cast<limb>(prod);
+        borrow = static_cast<limb>(prod >> limb_bits) + (r[i] < low);
+        r[i] -= low;
+    }
+
+    return borrow;
+}
+
+inline limb lshift_loop(limb* r, const limb* a, std::size_t n, int shift) {
+    limb out = a[n - 1] >> (limb_bits - shift);
+
+    for (std::size_t i = n - 1; i > 0; i--) {
+        r[i] = (a[i] << shift) | (a[i - 1] >> (limb_bits - shift));
+    }
+
+    r[0] = a[0] << shift;
+    return out;
+}
+
+inline limb rshift_loop(limb* r, const limb* a, std::size_t n, int shift) {
+    limb out = a[0] << (limb_bits - shift);
+
+    for (std::size_t i = 0; i + 1 < n; i++) {
+        r[i] = (a[i] >> shift) | (a[i + 1] << (limb_bits - shift));
+    }
+
+    r[n - 1] = a[n - 1] >> shift;
+    return out;
+}
+
+limb mul_1_portable(limb* r, const limb* a, std::size_t n, limb b) {
+    return mul_1_loop(r, a, n, b, 0);
+}
+
+limb addmul_1_portable(limb* r, const limb* a, std::size_t n, limb b) {
+    return addmul_1_loop(r, a, n, b, 0);
+}
+
+limb submul_1_portable(limb* r, const limb* a, std::size_t n, limb b) {
+    return submul_1_loop(r, a, n, b, 0);
+}
+
+limb lshift_portable(limb* r, const limb* a, std::size_t n, int shift) {
+    return lshift_loop(r, a, n, shift);
+}
+
+limb rshift_portable(limb* r, const limb* a, std::size_t n, int shift) {
+    return rshift_loop(r, a, n, shift);
+}
+
+//! The kernels that depend on the instruction set, picked once per process
+struct kernel_table {
+    const char* name;
+
+    limb (*mul_1)(limb* r, const limb* a, std::size_t n, limb b);
+    limb (*addmul_1)(limb* r, const limb* a, std::size_t n, limb b);
+    limb (*submul_1)(limb* r, const limb* a, std::size_t n, limb b);
+
+    limb (*lshift)(limb* r, const limb* a, std::size_t n, int shift);
+    limb (*rshift)(limb* r, const limb* a, std::size_t n, int shift);
+};
+
+const kernel_table portable_kernels = {
+    "portable", mul_1_portable, addmul_1_portable, submul_1_portable, lshift_portable, rshift_portable
+};
+
+#if defined(LIMBS_X86_64)
+
+//! BMI2 and ADX kernels. mulx leaves the flags alone, so the carries of the products
+//! (adcx, CF) and of the accumulation (adox, OF) run as two independent chains.
+//! The loops run four limbs at a time over a negative index in rcx, which lea and
+//! jrcxz step and test without touching either flag
+
+#define LIMBS_ADX_LOOP_END \
+    "leaq 4(%[i]), %[i]\n\t" \
+    "jrcxz 2f\n\t" \
+    "jmp 1b\n" \
+    "2:\n\t"
+
+limb mul_1_adx(limb* r, const limb* a, std::size_t n, limb b) {
+    std::size_t head = n & ~std::size_t(3);
+    limb high = 0;
+
+    if (head) {
+        limb l0, l1, h0, h1;
+        std::ptrdiff_t i = -static_cast<std::ptrdiff_t>(head);
+
+        __asm__(
+            "xorl %k[l0], %k[l0]\n"
+            "1:\n\t"
+            "mulx (%[a],%[i],8), %[l0], %[h0]\n\t"
+            "mulx 8(%[a],%[i],8), %[l1], %[h1]\n\t"
+            "adcx %[high], %[l0]\n\t"
+            "adcx %[h0], %[l1]\n\t"
+            "movq %[l0], (%[r],%[i],8)\n\t"
+            "movq %[l1], 8(%[r],%[i],8)\n\t"
+            "mulx 16(%[a],%[i],8), %[l0], %[h0]\n\t"
+            "mulx 24(%[a],%[i],8), %[l1], %[high]\n\t"
+            "adcx %[h1], %[l0]\n\t"
+            "adcx %[h0], %[l1]\n\t"
+            "movq %[l0], 16(%[r],%[i],8)\n\t"
+            "movq %[l1], 24(%[r],%[i],8)\n\t"
+            LIMBS_ADX_LOOP_END
+            "movl $0, %k[h0]\n\t"
+            "adcx %[h0], %[high]\n"
+            : [high] "+&r"(high), [l0] "=&r"(l0), [l1] "=&r"(l1), [h0] "=&r"(h0), [h1] "=&r"(h1), [i] "+c"(i)
+            : [a] "r"(a + head), [r] "r"(r + head), "d"(b)
+            : "cc", "memory");
+    }
+
+    return mul_1_loop(r + head, a + head, n - head, b, high);
+}
+
+limb addmul_1_adx(limb* r, const limb* a, std::size_t n, limb b) {
+    std::size_t head = n & ~std::size_t(3);
+    limb high = 0;
+
+    if (head) {
+        limb l0, l1, h0, h1;
+        std::ptrdiff_t i = -static_cast<std::ptrdiff_t>(head);
+
+        __asm__(
+            "xorl %k[l0], %k[l0]\n"
+            "1:\n\t"
+            "mulx (%[a],%[i],8), %[l0], %[h0]\n\t"
+            "mulx 8(%[a],%[i],8), %[l1], %[h1]\n\t"
+            "adcx %[high], %[l0]\n\t"
+            "adox (%[r],%[i],8), %[l0]\n\t"
+            "adcx %[h0], %[l1]\n\t"
+            "adox 8(%[r],%[i],8), %[l1]\n\t"
+            "movq %[l0], (%[r],%[i],8)\n\t"
+            "movq %[l1], 8(%[r],%[i],8)\n\t"
+            "mulx 16(%[a],%[i],8), %[l0], %[h0]\n\t"
+            "mulx 24(%[a],%[i],8), %[l1], %[high]\n\t"
+            "adcx %[h1], %[l0]\n\t"
+            "adox 16(%[r],%[i],8), %[l0]\n\t"
+            "adcx %[h0], %[l1]\n\t"
+            "adox 24(%[r],%[i],8), %[l1]\n\t"
+            "movq %[l0], 16(%[r],%[i],8)\n\t"
+            "movq %[l1], 24(%[r],%[i],8)\n\t"
+            LIMBS_ADX_LOOP_END
+            "movl $0, %k[h0]\n\t"
+            "adcx %[h0], %[high]\n\t"
+            "adox %[h0], %[high]\n"
+            : [high] "+&r"(high), [l0] "=&r"(l0), [l1] "=&r"(l1), [h0] "=&r"(h0), [h1] "=&r"(h1), [i] "+c"(i)
+            : [a] "r"(a + head), [r] "r"(r + head), "d"(b)
+            : "cc", "memory");
+    }
+
+    return addmul_1_loop(r + head, a + head, n - head, b, high);
+}
+
+//! r - t is computed as ~(~r + t), which turns the borrow chain into a carry chain for adox
+limb submul_1_adx(limb* r, const limb* a, std::size_t n, limb b) {
+    std::size_t head = n & ~std::size_t(3);
+    limb high = 0;
+
+    if (head) {
+        limb l0, l1, h0, h1, t;
+        std::ptrdiff_t i = -static_cast<std::ptrdiff_t>(head);
+
+        __asm__(
+            "xorl %k[l0], %k[l0]\n"
+            "1:\n\t"
+            "mulx (%[a],%[i],8), %[l0], %[h0]\n\t"
+            "mulx 8(%[a],%[i],8), %[l1], %[h1]\n\t"
+            "adcx %[high], %[l0]\n\t"
+            "adcx %[h0], %[l1]\n\t"
+            "movq (%[r],%[i],8), %[t]\n\t"
+            "notq %[t]\n\t"
+            "adox %[l0], %[t]\n\t"
+            "notq %[t]\n\t"
+            "movq %[t], (%[r],%[i],8)\n\t"
+            "movq 8(%[r],%[i],8), %[t]\n\t"
+            "notq %[t]\n\t"
+            "adox %[l1], %[t]\n\t"
+            "notq %[t]\n\t"
+            "movq %[t], 8(%[r],%[i],8)\n\t"
+            "mulx 16(%[a],%[i],8), %[l0], %[h0]\n\t"
+            "mulx 24(%[a],%[i],8), %[l1], %[high]\n\t"
+            "adcx %[h1], %[l0]\n\t"
+            "adcx %[h0], %[l1]\n\t"
+            "movq 16(%[r],%[i],8), %[t]\n\t"
+            "notq %[t]\n\t"
+            "adox %[l0], %[t]\n\t"
+            "notq %[t]\n\t"
+            "movq %[t], 16(%[r],%[i],8)\n\t"
+            "movq 24(%[r],%[i],8), %[t]\n\t"
+            "notq %[t]\n\t"
+            "adox %[l1], %[t]\n\t"
+            "notq %[t]\n\t"
+            "movq %[t], 24(%[r],%[i],8)\n\t"
+            LIMBS_ADX_LOOP_END
+            "movl $0, %k[h0]\n\t"
+            "adcx %[h0], %[high]\n\t"
+            "adox %[h0], %[high]\n"
+            : [high] "+&r"(high), [l0] "=&r"(l0), [l1] "=&r"(l1), [h0] "=&r"(h0), [h1] "=&r"(h1), [t] "=&r"(t), [i] "+c"(i)
+            : [a] "r"(a + head), [r] "r"(r + head), "d"(b)
+            : "cc", "memory");
+    }
+
+    return submul_1_loop(r + head, a + head, n - head, b, high);
+}
+
+#undef LIMBS_ADX_LOOP_END
+
+//! The portable shifts compiled with shlx and shrx, which take the count in any register
+__attribute__((target("bmi2"))) limb lshift_bmi2(limb* r, const limb* a, std::size_t n, int shift) {
+    return lshift_loop(r, a, n, shift);
+}
+
+__attribute__((target("bmi2"))) limb rshift_bmi2(limb* r, const limb* a, std::size_t n, int shift) {
+    return rshift_loop(r, a, n, shift);
+}
+
+const kernel_table adx_kernels = {
+    "adx", mul_1_adx, addmul_1_adx, submul_1_adx, lshift_bmi2, rshift_bmi2
+};
+
+#endif
+
+const kernel_table* detect_kernels() {
+#if defined(LIMBS_X86_64)
+    unsigned eax, ebx, ecx, edx;
+
+    // Structured extended features: ebx bit 8 is BMI2, bit 19 is ADX
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx >> 8 & 1) && (ebx >> 19 & 1)) return &adx_kernels;
+#endif
+
+    return &portable_kernels;
+}
+
+//! The tables are constants, so a relaxed load is enough even on the first racing calls
+std::atomic<const kernel_table*> active_kernels{nullptr};
+
+const kernel_table& kernels() {
+    const kernel_table* table = active_kernels.load(std::memory_order_relaxed);
+
+    if (!table) {
+        table = detect_kernels();
+        active_kernels.store(table, std::memory_order_relaxed);
+    }
+
+    return *table;
+}
+
+} // namespace
+
+std::size_t normalized_size(const limb* a, std::size_t n) {
+    while (n > 0 && a[n - 1] == 0) n--;
+    return n;
+}
+
+int cmp(const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    if (an != bn) return an < bn ? -1 : 1;
+
+    for (std::size_t i = an; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+limb add_n(limb* r, const limb* a, const limb* b, std::size_t n) {
+    unsigned char carry = 0;
+    std::size_t i = 0;
+
+    // Unrolled so that the carry stays in the flags across the limbs
+    for (; i + 4 <= n; i += 4) {
+        limb s0 = add_carry(a[i], b[i], carry);
+        limb s1 = add_carry(a[i + 1], b[i + 1], carry);
+        limb s2 = add_carry(a[i + 2], b[i + 2], carry);
+        limb s3 = add_carry(a[i + 3], b[i + 3], carry);
+
+        r[i] = s0;
+        r[i + 1] = s1;
+        r[i + 2] = s2;
+        r[i + 3] = s3;
+    }
+
+    for (; i < n; i++) r[i] = add_carry(a[i], b[i], carry);
+
+    return carry;
+}
+
+limb sub_n(limb* r, const limb* a, const limb* b, std::size_t n) {
+    unsigned char borrow = 0;
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        limb d0 = sub_borrow(a[i], b[i], borrow);
+        limb d1 = sub_borrow(a[i + 1], b[i + 1], borrow);
+        limb d2 = sub_borrow(a[i + 2], b[i + 2], borrow);
+        limb d3 = sub_borrow(a[i + 3], b[i + 3], borrow);
+
+        r[i] = d0;
+        r[i + 1] = d1;
+        r[i + 2] = d2;
+        r[i + 3] = d3;
+    }
+
+    for (; i < n; i++) r[i] = sub_borrow(a[i], b[i], borrow);
+
+    return borrow;
+}
+
+limb add(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    limb carry = add_n(r, a, b, bn);
+
+    for (std::size_t i = bn; i < an; i++) {
+        r[i] = a[i] + carry;
+        carry = (r[i] < carry);
+    }
+
+    return carry;
+}
+
+limb sub(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    limb borrow = sub_n(r, a, b, bn);
+
+    for (std::size_t i = bn; i < an; i++) {
+        limb current = a[i];
+        r[i] = current - borrow;
+        borrow = (current < borrow);
+    }
+
+    return borrow;
+}
+
+limb mul_1(limb* r, const limb* a, std::size_t n, limb b) {
+    return kernels().mul_1(r, a, n, b);
+}
+
+limb addmul_1(limb* r, const limb* a, std::size_t n, limb b) {
+    return kernels().addmul_1(r, a, n, b);
+}
+
+limb submul_1(limb* r, const limb* a, std::size_t n, limb b) {
+    return kernels().submul_1(r, a, n, b);
+}
+
+limb lshift(limb* r, const limb* a, std::size_t n, int shift) {
+    return kernels().lshift(r, a, n, shift);
+}
+
+limb rshift(limb* r, const limb* a, std::size_t n, int shift) {
+    return kernels().rshift(r, a, n, shift);
+}
+
+const char* kernel_name() {
+    return kernels().name;
+}
+
+void use_portable_kernels(bool portable) {
+    active_kernels.store(portable ? &portable_kernels : detect_kernels(), std::memory_order_relaxed);
+}
+
+void mul_basecase(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    const kernel_table& table = kernels();
+
+    r[an] = table.mul_1(r, a, an, b[0]);
+
+    for (std::size_t j = 1; j < bn; j++) {
+        r[an + j] = table.addmul_1(r + j, a, an, b[j]);
+    }
+}
+
+limb divrem_1(limb* q, const limb* a, std::size_t n, limb d) {
+    limb remainder = 0;
+
+    for (std::size_t i = n; i-- > 0;) {
+        dlimb current = (static_cast<dlimb>(remainder) << limb_bits) | a[i];
+        q[i] = static_cast<limb>(current / d);
+        remainder = static_cast<limb>(current % d);
+    }
+
+    return remainder;
+}
+
+} // namespace limbs
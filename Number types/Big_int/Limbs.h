@@ -0,0 +1,123 @@
+#ifndef LIMBS_H
+#define LIMBS_H
+
+#include <cstddef>
+#include <cstdint>
+
+//! Low-level routines over little-endian arrays of 64-bit limbs.
+//! All functions work on raw pointers, never allocate and assume the caller
+//! has already sized the destination. They are the building blocks of bigint.
+
+class thread_pool;
+
+namespace limbs {
+
+using limb = std::uint64_t;
+using dlimb = unsigned __int128;
+
+constexpr int limb_bits = 64;
+
+//! Length of a without its most significant zero limbs
+std::size_t normalized_size(const limb* a, std::size_t n);
+
+//! Compares two normalized magnitudes, returns -1, 0 or 1
+int cmp(const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+//! r[0..n) = a[0..n) + b[0..n), returns the carry
+limb add_n(limb* r, const limb* a, const limb* b, std::size_t n);
+
+//! r[0..n) = a[0..n) - b[0..n), returns the borrow
+limb sub_n(limb* r, const limb* a, const limb* b, std::size_t n);
+
+//! r[0..an) = a[0..an) + b[0..bn) with an >= bn, returns the carry
+limb add(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+//! r[0..an) = a[0..an) - b[0..bn) with an >= bn, returns the borrow
+limb sub(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+//! r[0..n) = a[0..n) * b, returns the high limb
+limb mul_1(limb* r, const limb* a, std::size_t n, limb b);
+
+//! r[0..n) += a[0..n) * b, returns the high limb
+limb addmul_1(limb* r, const limb* a, std::size_t n, limb b);
+
+//! r[0..n) -= a[0..n) * b, returns the borrowed high limb
+limb submul_1(limb* r, const limb* a, std::size_t n, limb b);
+
+//! r[0..n) = a[0..n) << shift for 0 < shift < limb_bits, returns the bits shifted out
+limb lshift(limb* r, const limb* a, std::size_t n, int shift);
+
+//! r[0..n) = a[0..n) >> shift for 0 < shift < limb_bits, returns the bits shifted out
+//! in the high end of the result limb
+limb rshift(limb* r, const limb* a, std::size_t n, int shift);
+
+//! r[0..an + bn) = a * b, r must not overlap the inputs
+void mul_basecase(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+//! q[0..n) = a[0..n) / d, returns a mod d; q may alias a
+limb divrem_1(limb* q, const limb* a, std::size_t n, limb d);
+
+//! mul_1, addmul_1, submul_1 and the shifts have several implementations, picked on the
+//! first call from the CPU features: "adx" (x86-64 with BMI2 and ADX) or "portable"
+const char* kernel_name();
+
+//! Switches to the portable kernels, or back to the detected ones, for tests and benchmarks
+void use_portable_kernels(bool portable);
+
+//! Multiplication, see Multiplication.cpp
+
+//! Operand sizes (in limbs of the shorter factor) where the faster algorithms take over
+constexpr std::size_t karatsuba_threshold = 32;
+constexpr std::size_t toom3_threshold = 192;
+constexpr std::size_t ntt_threshold = std::size_t(1) << 16;
+
+//! The three-prime transform is exact for products of at most this many limbs
+constexpr std::size_t ntt_max_limbs = (std::size_t(1) << 23) * 30 / limb_bits;
+
+//! r[0..an + bn) = a * b with an, bn > 0, r must not overlap the inputs.
+//! Picks schoolbook, Karatsuba or Toom-3 depending on the sizes
+void mul(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+void mul_karatsuba(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+void mul_toom3(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+//! Number-theoretic transform product over three primes recombined with the CRT,
+//! requires an + bn <= ntt_max_limbs
+void mul_ntt(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+//! Products whose shorter factor has at least parallel_threshold() limbs spread their
+//! recursive Karatsuba/Toom-3 products, the pieces of unbalanced products and the three
+//! NTT primes over a shared work-stealing pool (see Thread_pool.h) of thread_count() threads,
+//! the calling one included. Smaller products, and all of them with one thread, stay serial.
+//! Changing the settings while a multiplication runs on another thread is not allowed
+constexpr std::size_t default_parallel_threshold = 2048;
+
+//! 0 picks std::thread::hardware_concurrency(), the default
+void set_thread_count(std::size_t threads);
+std::size_t thread_count();
+
+//! The pool behind the parallel products, of thread_count() - 1 workers, or nullptr with one
+//! thread. Other parallel code over bigints (rns_vector) shares it rather than oversubscribing
+//! the cores with a pool of its own
+thread_pool* shared_thread_pool();
+
+void set_parallel_threshold(std::size_t limbs);
+std::size_t parallel_threshold();
+
+//! Division, see Division.cpp
+
+//! Divisor sizes (in limbs) where the recursive algorithms take over
+constexpr std::size_t burnikel_ziegler_threshold = 48;
+constexpr std::size_t newton_division_threshold = std::size_t(1) << 18;
+
+//! q[0..an - bn + 1) = a / b and r[0..bn) = a mod b with an >= bn > 0 and b[bn - 1] != 0.
+//! Picks Knuth's algorithm D, Burnikel-Ziegler or Newton reciprocal division depending on the sizes
+void divrem(limb* q, limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+
+//! Knuth's algorithm D. The divisor must have its top bit set, u[0..un) is replaced by the
+//! remainder in u[0..dn) and q receives un - dn + 1 limbs
+void divrem_basecase(limb* q, limb* u, std::size_t un, const limb* d, std::size_t dn);
+
+} // namespace limbs
+
+#endif // LIMBS_H
@@ -0,0 +1,327 @@
+#include "Montgomery.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+using limb = bigint::limb;
+using buffer = std::vector<limb>;
+
+//! From this many limbs on, the reduction uses two full products (which take the
+//! Karatsuba and Toom paths) instead of k multiply-accumulate passes
+constexpr std::size_t redc_product_threshold = 1536;
+
+std::size_t bit_length(const limb_buffer& e) {
+    if (e.empty()) return 0;
+    return e.size() * limbs::limb_bits - __builtin_clzll(e.back());
+}
+
+//! Bits [low, high) of e, at most one limb wide
+limb bit_range(const limb_buffer& e, std::size_t low, std::size_t high) {
+    limb value = 0;
+
+    for (std::size_t i = high; i-- > low;) {
+        value = value << 1 | (i / limbs::limb_bits < e.size() ? e[i / limbs::limb_bits] >> (i % limbs::limb_bits) & 1 : 0);
+    }
+
+    return value;
+}
+
+//! Window width that minimizes squarings plus table multiplications for an exponent of this size
+std::size_t window_bits(std::size_t exponent_bits) {
+    if (exponent_bits > 671) return 6;
+    if (exponent_bits > 239) return 5;
+    if (exponent_bits > 79) return 4;
+    if (exponent_bits > 23) return 3;
+    return 2;
+}
+
+void check_exponent(const bigint& exponent) {
+    if (exponent._sign() < 0) throw std::invalid_argument("powmod: negative exponent");
+}
+
+} // namespace
+
+//! Rule of five
+
+montgomery_context::montgomery_context(const bigint& modulus): n(modulus) {
+    const limb_buffer& m = modulus._limbs();
+    if (modulus._sign() < 0 || m.empty() || !(m[0] & 1)) throw std::invalid_argument("montgomery_context: modulus must be odd and positive");
+
+    std::size_t k = m.size();
+    modulus_limbs.assign(m.begin(), m.end());
+
+    // Newton iteration for n^-1 mod 2^64, each step doubles the correct bits (n n = 1 mod 8 to start)
+    limb x = m[0];
+    for (int i = 0; i < 5; i++) x *= 2 - m[0] * x;
+    inverse_limb = 0 - x;
+
+    if (k >= redc_product_threshold) {
+        // The same iteration over whole limbs: x = x (2 - n x) mod 2^(64 next)
+        buffer y(k), e(k), product(2 * k);
+        y[0] = x;
+
+        for (std::size_t done = 1; done < k;) {
+            std::size_t next = std::min(2 * done, k);
+
+            limbs::mul(product.data(), modulus_limbs.data(), next, y.data(), done);
+            for (std::size_t i = 0; i < next; i++) e[i] = ~product[i];
+
+            // 2 - t = ~t + 3
+            limb carry = 3;
+            for (std::size_t i = 0; i < next && carry; i++) {
+                e[i] += carry;
+                carry = (e[i] < carry);
+            }
+
+            limbs::mul(product.data(), e.data(), next, y.data(), done);
+            std::copy(product.begin(), product.begin() + next, y.begin());
+            done = next;
+        }
+
+        // -y mod R = ~y + 1
+        inverse.resize(k);
+        limb carry = 1;
+        for (std::size_t i = 0; i < k; i++) {
+            inverse[i] = ~y[i] + carry;
+            carry = (inverse[i] < carry);
+        }
+    }
+
+    bigint r, r2;
+    r._limbs().resize(k + 1);
+    r._limbs()[k] = 1;
+    r2._limbs().resize(2 * k + 1);
+    r2._limbs()[2 * k] = 1;
+
+    one = reduced(r);
+    r_squared = reduced(r2);
+}
+
+//! Private methods
+
+std::size_t montgomery_context::size() const {
+    return modulus_limbs.size();
+}
+
+void montgomery_context::reduce(limb* r, limb* t, limb* scratch) const {
+    std::size_t k = size();
+    const limb* m = modulus_limbs.data();
+    limb carry;
+
+    if (k < redc_product_threshold) {
+        // Clearing limb i leaves a carry for limb i + k. Later steps only read limbs below k
+        // of the running value, so the carries are parked in the cleared limbs and added at the end
+        for (std::size_t i = 0; i < k; i++) {
+            t[i] = limbs::addmul_1(t + i, m, k, t[i] * inverse_limb);
+        }
+
+        carry = limbs::add_n(r, t + k, t, k);
+    }
+    else {
+        // q = (t mod R) (-n^-1) mod R makes t + q n divisible by R
+        limb* q = scratch;
+        limb* u = scratch + 2 * k;
+
+        limbs::mul(q, t, k, inverse.data(), k);
+        limbs::mul(u, q, k, m, k);
+
+        carry = limbs::add_n(u, u, t, 2 * k);
+        std::copy(u + k, u + 2 * k, r);
+    }
+
+    // The result is below 2n
+    if (carry || limbs::cmp(r, k, m, k) >= 0) limbs::sub_n(r, r, m, k);
+}
+
+void montgomery_context::multiply(limb* r, const limb* a, const limb* b, limb* scratch) const {
+    std::size_t k = size();
+
+    limbs::mul(scratch, a, k, b, k);
+    reduce(r, scratch, scratch + 2 * k);
+}
+
+std::vector<limb> montgomery_context::reduced(const bigint& x) const {
+    buffer result(size());
+    const limb_buffer& digits = x._limbs();
+
+    if (x._sign() > 0 && limbs::cmp(digits.data(), digits.size(), modulus_limbs.data(), size()) < 0) {
+        std::copy(digits.begin(), digits.end(), result.begin());
+        return result;
+    }
+
+    bigint remainder = x % n;
+    if (remainder._sign() < 0) remainder += n;
+
+    std::copy(remainder._limbs().begin(), remainder._limbs().end(), result.begin());
+    return result;
+}
+
+bigint montgomery_context::to_bigint(const limb* x) const {
+    bigint result;
+
+    result._limbs() = limb_buffer(x, x + size());
+    result.trim_zeros();
+
+    return result;
+}
+
+//! Methods
+
+const bigint& montgomery_context::modulus() const {
+    return n;
+}
+
+bigint montgomery_context::to_montgomery(const bigint& x) const {
+    buffer value = reduced(x), scratch(6 * size());
+
+    multiply(value.data(), value.data(), r_squared.data(), scratch.data());
+    return to_bigint(value.data());
+}
+
+bigint montgomery_context::from_montgomery(const bigint& x) const {
+    std::size_t k = size();
+    buffer value = reduced(x), scratch(6 * k);
+
+    value.resize(2 * k);
+    reduce(value.data(), value.data(), scratch.data() + 2 * k);
+
+    return to_bigint(value.data());
+}
+
+bigint montgomery_context::multiply(const bigint& a, const bigint& b) const {
+    buffer x = reduced(a), y = reduced(b), scratch(6 * size());
+
+    multiply(x.data(), x.data(), y.data(), scratch.data());
+    return to_bigint(x.data());
+}
+
+bigint montgomery_context::powmod(const bigint& base, const bigint& exponent) const {
+    check_exponent(exponent);
+
+    const limb_buffer& e = exponent._limbs();
+    std::size_t k = size(), bits = bit_length(e);
+
+    if (!bits) return from_montgomery(to_bigint(one.data()));
+
+    // Odd powers base^1, base^3, ..., base^(2^window - 1) in Montgomery form
+    std::size_t window = window_bits(bits);
+    buffer scratch(6 * k), table(k << (window - 1)), square(k), result(k);
+
+    buffer b = reduced(base);
+    multiply(table.data(), b.data(), r_squared.data(), scratch.data());
+    multiply(square.data(), table.data(), table.data(), scratch.data());
+
+    for (std::size_t j = 1; j < (std::size_t(1) << (window - 1)); j++) {
+        multiply(table.data() + j * k, table.data() + (j - 1) * k, square.data(), scratch.data());
+    }
+
+    // Left to right; every window starts and ends on a set bit, zeros in between are single squarings
+    bool started = false;
+
+    for (std::size_t i = bits; i > 0;) {
+        if (!bit_range(e, i - 1, i)) {
+            multiply(result.data(), result.data(), result.data(), scratch.data());
+            i--;
+            continue;
+        }
+
+        std::size_t low = (i > window ? i - window : 0);
+        while (!bit_range(e, low, low + 1)) low++;
+
+        const limb* power = table.data() + (bit_range(e, low, i) >> 1) * k;
+
+        if (!started) {
+            std::copy(power, power + k, result.begin());
+            started = true;
+        }
+        else {
+            for (std::size_t j = low; j < i; j++) multiply(result.data(), result.data(), result.data(), scratch.data());
+            multiply(result.data(), result.data(), power, scratch.data());
+        }
+
+        i = low;
+    }
+
+    result.resize(2 * k);
+    reduce(result.data(), result.data(), scratch.data());
+
+    return to_bigint(result.data());
+}
+
+bigint montgomery_context::powmod(const std::vector<bigint>& bases, const std::vector<bigint>& exponents) const {
+    if (bases.size() != exponents.size()) throw std::invalid_argument("powmod: bases and exponents differ in number");
+
+    std::size_t k = size(), count = bases.size(), bits = 0;
+
+    for (const bigint& exponent : exponents) {
+        check_exponent(exponent);
+        bits = std::max(bits, bit_length(exponent._limbs()));
+    }
+
+    if (!bits) return from_montgomery(to_bigint(one.data()));
+
+    // Fixed windows, so that all the exponents are scanned in step (Straus).
+    // tables[i] holds bases[i]^1 .. bases[i]^(2^window - 1)
+    std::size_t window = std::min<std::size_t>(window_bits(bits), 4), entries = (std::size_t(1) << window) - 1;
+    buffer scratch(6 * k), tables(count * entries * k), result(k);
+
+    for (std::size_t i = 0; i < count; i++) {
+        limb* table = tables.data() + i * entries * k;
+        buffer b = reduced(bases[i]);
+
+        multiply(table, b.data(), r_squared.data(), scratch.data());
+        for (std::size_t j = 1; j < entries; j++) multiply(table + j * k, table + (j - 1) * k, table, scratch.data());
+    }
+
+    bool started = false;
+
+    for (std::size_t high = (bits + window - 1) / window * window; high > 0; high -= window) {
+        if (started) {
+            for (std::size_t j = 0; j < window; j++) multiply(result.data(), result.data(), result.data(), scratch.data());
+        }
+
+        for (std::size_t i = 0; i < count; i++) {
+            limb digit = bit_range(exponents[i]._limbs(), high - window, high);
+            if (!digit) continue;
+
+            const limb* power = tables.data() + (i * entries + digit - 1) * k;
+
+            if (!started) {
+                std::copy(power, power + k, result.begin());
+                started = true;
+            }
+            else {
+                multiply(result.data(), result.data(), power, scratch.data());
+            }
+        }
+    }
+
+    result.resize(2 * k);
+    reduce(result.data(), result.data(), scratch.data());
+
+    return to_bigint(result.data());
+}
+
+//! Out-of-class functions
+
+bigint powmod(const bigint& base, const bigint& exponent, const bigint& modulus) {
+    if (!modulus || modulus._sign() < 0) throw std::invalid_argument("powmod: modulus must be positive");
+    if (modulus._limbs()[0] & 1) return montgomery_context(modulus).powmod(base, exponent);
+
+    check_exponent(exponent);
+
+    // Even moduli have no Montgomery form, so they take a division per step
+    const limb_buffer& e = exponent._limbs();
+    bigint b = base % modulus, result = 1;
+
+    if (b._sign() < 0) b += modulus;
+
+    for (std::size_t i = bit_length(e); i-- > 0;) {
+        result = result * result % modulus;
+        if (bit_range(e, i, i + 1)) result = result * b % modulus;
+    }
+
+    return result % modulus;
+}
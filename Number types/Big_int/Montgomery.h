@@ -0,0 +1,64 @@
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Bigint.h"
+
+//! Arithmetic modulo an odd n in Montgomery form: a residue x is kept as x R mod n with
+//! R = 2^(64 k), k being the number of limbs of n, so that reducing a product takes two
+//! multiplications instead of a division. Building the context costs two divisions,
+//! after that every operation is division-free
+class montgomery_context {
+public:
+    using limb = bigint::limb;
+private:
+    bigint n;
+    std::vector<limb> modulus_limbs;
+    limb inverse_limb;          // -n^-1 mod 2^64
+    std::vector<limb> inverse;  // -n^-1 mod R, only for the moduli reduced with full products
+    std::vector<limb> one;      // R mod n
+    std::vector<limb> r_squared; // R^2 mod n
+
+    std::size_t size() const;
+
+    //! r[0..k) = t R^-1 mod n for t < n R, t[0..2k) is destroyed; scratch holds 4k limbs
+    void reduce(limb* r, limb* t, limb* scratch) const;
+
+    //! r[0..k) = a b R^-1 mod n, r may alias a or b; scratch holds 6k limbs
+    void multiply(limb* r, const limb* a, const limb* b, limb* scratch) const;
+
+    //! x mod n as exactly k limbs
+    std::vector<limb> reduced(const bigint& x) const;
+
+    bigint to_bigint(const limb* x) const;
+public:
+    //! Rule of five
+    //! Throws std::invalid_argument unless modulus is odd and positive
+    explicit montgomery_context(const bigint& modulus);
+
+    //! Methods
+
+    const bigint& modulus() const;
+
+    //! x R mod n and back, for chaining multiply() by hand
+    bigint to_montgomery(const bigint& x) const;
+    bigint from_montgomery(const bigint& x) const;
+
+    //! a b R^-1 mod n, the Montgomery form of the product of two Montgomery forms
+    bigint multiply(const bigint& a, const bigint& b) const;
+
+    //! base^exponent mod n by sliding windows, in plain (not Montgomery) form.
+    //! Throws std::invalid_argument for a negative exponent
+    bigint powmod(const bigint& base, const bigint& exponent) const;
+
+    //! Product of bases[i]^exponents[i] mod n. All powers share one chain of squarings,
+    //! which makes it much cheaper than separate powmod calls
+    bigint powmod(const std::vector<bigint>& bases, const std::vector<bigint>& exponents) const;
+};
+
+//! base^exponent mod modulus for a positive modulus, through montgomery_context when it is odd
+bigint powmod(const bigint& base, const bigint& exponent, const bigint& modulus);
+
+#endif // MONTGOMERY_H
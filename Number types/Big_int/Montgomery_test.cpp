@@ -0,0 +1,116 @@
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include "Bigint.h"
+#include "Montgomery.h"
+
+//! A random integer of at most bits bits, with a random sign
+bigint random_bigint(std::mt19937_64& random, std::size_t bits) {
+    bigint result = 0;
+
+    for (std::size_t i = 0; i < bits; i += 32) result = result * bigint(std::uint64_t(1) << 32) + bigint(random() >> 32);
+    if (random() % 2) result = -result;
+
+    return result;
+}
+
+bigint random_modulus(std::mt19937_64& random, std::size_t bits, bool odd) {
+    bigint result = random_bigint(random, bits).abs() + bigint(2);
+    if ((result % bigint(2) == bigint(1)) != odd) result += bigint(1);
+
+    return result;
+}
+
+//! Square and multiply with a division per step, the exponent halved until it is zero
+bigint plain_powmod(const bigint& base, bigint exponent, const bigint& modulus) {
+    bigint result = bigint(1) % modulus, power = base % modulus;
+    if (power < bigint(0)) power += modulus;
+
+    for (; exponent > bigint(0); exponent = exponent / bigint(2)) {
+        if (exponent % bigint(2) == bigint(1)) result = result * power % modulus;
+        power = power * power % modulus;
+    }
+
+    return result;
+}
+
+//! Montgomery products and sliding-window powers against plain_powmod, for odd moduli of the given bits
+bool check_context(std::size_t modulus_bits, std::size_t exponent_bits, int tests) {
+    std::mt19937_64 random(modulus_bits * 1000 + exponent_bits);
+    bool result = true;
+
+    for (int test = 0; test < tests; test++) {
+        bigint n = random_modulus(random, modulus_bits, true);
+        montgomery_context context(n);
+
+        bigint a = random_bigint(random, modulus_bits + 10), b = random_bigint(random, modulus_bits);
+        bigint e = random_bigint(random, exponent_bits).abs();
+
+        bigint product = a * b % n;
+        if (product < bigint(0)) product += n;
+
+        result &= (context.from_montgomery(context.multiply(context.to_montgomery(a), context.to_montgomery(b))) == product);
+        result &= (context.powmod(a, e) == plain_powmod(a, e, n) && powmod(a, e, n) == plain_powmod(a, e, n));
+        result &= (context.powmod(a, bigint(0)) == bigint(1) % n);
+    }
+
+    return result;
+}
+
+//! The product of several powers, with one exponent zero and the others of unequal lengths
+bool check_multi_exponent(std::size_t modulus_bits, std::size_t count) {
+    std::mt19937_64 random(modulus_bits * 1000 + count);
+
+    bigint n = random_modulus(random, modulus_bits, true);
+    montgomery_context context(n);
+
+    std::vector<bigint> bases(count), exponents(count);
+    bigint expected = bigint(1) % n;
+
+    for (std::size_t i = 0; i < count; i++) {
+        bases[i] = random_bigint(random, modulus_bits);
+        exponents[i] = (i == 1 ? bigint(0) : random_bigint(random, 64 * (i + 1)).abs());
+        expected = expected * plain_powmod(bases[i], exponents[i], n) % n;
+    }
+
+    return context.powmod(bases, exponents) == expected;
+}
+
+//! Even moduli go through the division fallback of powmod, which montgomery_context refuses
+bool check_even_modulus(std::size_t modulus_bits) {
+    std::mt19937_64 random(modulus_bits);
+    bool result = true;
+
+    for (int test = 0; test < 20; test++) {
+        bigint n = random_modulus(random, modulus_bits, false);
+        bigint a = random_bigint(random, modulus_bits * 2), e = random_bigint(random, 200).abs();
+
+        result &= (powmod(a, e, n) == plain_powmod(a, e, n));
+    }
+
+    try {
+        montgomery_context context(random_modulus(random, modulus_bits, false));
+        result = false;
+    } catch (const std::invalid_argument&) {}
+
+    try {
+        powmod(bigint(3), bigint(-1), bigint(7));
+        result = false;
+    } catch (const std::invalid_argument&) {}
+
+    return result;
+}
+
+int main() {
+    std::cout << "one limb: " << check_context(60, 64, 200) << std::endl;
+    std::cout << "2048 bits: " << check_context(2048, 2048, 10) << std::endl;
+    std::cout << "5000 bits, short exponents: " << check_context(5000, 30, 10) << std::endl;
+
+    // 1536 limbs and more are reduced with full products instead of a limb at a time
+    std::cout << "100000 bits: " << check_context(100000, 20, 2) << std::endl;
+
+    std::cout << "multi-exponent, 3 bases: " << check_multi_exponent(1024, 3) << std::endl;
+    std::cout << "multi-exponent, 8 bases: " << check_multi_exponent(300, 8) << std::endl;
+
+    std::cout << "even moduli: " << check_even_modulus(1000) << std::endl;
+}
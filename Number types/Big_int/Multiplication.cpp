@@ -0,0 +1,379 @@
+#include "Limbs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Thread_pool.h"
+
+#include "../Number field of prime order/Number_field.h"
+#include "../Number field of prime order/Number_field.cpp"
+#include "../Number field of prime order/Modular.cpp"
+#include "../Number field of prime order/NTT.h"
+#include "../Number field of prime order/NTT.cpp"
+
+namespace limbs {
+
+namespace {
+
+using buffer = std::vector<limb>;
+
+std::atomic<std::size_t> requested_threads{0};
+std::atomic<std::size_t> threshold{default_parallel_threshold};
+
+std::mutex pool_lock;
+std::unique_ptr<thread_pool> shared_pool;
+
+//! The pool for a product whose shorter factor has bn limbs, nullptr if it stays serial
+thread_pool* parallel_pool(std::size_t bn) {
+    if (bn < threshold.load(std::memory_order_relaxed)) return nullptr;
+
+    return shared_thread_pool();
+}
+
+//! Runs the tasks of a product whose shorter factor has bn limbs, all but the
+//! first on the pool when the product is large enough
+template<typename First, typename... Rest>
+void run_tasks(std::size_t bn, First&& first, Rest&&... rest) {
+    thread_pool* workers = parallel_pool(bn);
+
+    if (!workers) {
+        first();
+        (rest(), ...);
+        return;
+    }
+
+    task_group group(*workers);
+    (group.run(rest), ...);
+
+    first();
+    group.wait();
+}
+
+//! Signed intermediate value of Toom-3 evaluation and interpolation
+struct signed_value {
+    buffer magnitude; // normalized
+    int sign = 1;
+};
+
+signed_value make_value(const limb* a, std::size_t n) {
+    n = normalized_size(a, n);
+    return signed_value{buffer(a, a + n), 1};
+}
+
+buffer add_magnitudes(const buffer& a, const buffer& b) {
+    const buffer& longer = (a.size() >= b.size() ? a : b);
+    const buffer& shorter = (a.size() >= b.size() ? b : a);
+
+    buffer result(longer.size() + 1);
+    result.back() = add(result.data(), longer.data(), longer.size(), shorter.data(), shorter.size());
+
+    if (!result.back()) result.pop_back();
+    return result;
+}
+
+buffer sub_magnitudes(const buffer& a, const buffer& b) {
+    buffer result(a.size());
+    sub(result.data(), a.data(), a.size(), b.data(), b.size());
+
+    result.resize(normalized_size(result.data(), result.size()));
+    return result;
+}
+
+//! a + b_sign * b
+signed_value add_values(const signed_value& a, const signed_value& b, int b_sign = 1) {
+    int sign = b.sign * b_sign;
+
+    if (a.sign == sign) return signed_value{add_magnitudes(a.magnitude, b.magnitude), a.sign};
+
+    int order = cmp(a.magnitude.data(), a.magnitude.size(), b.magnitude.data(), b.magnitude.size());
+
+    if (order >= 0) return signed_value{sub_magnitudes(a.magnitude, b.magnitude), order ? a.sign : 1};
+    return signed_value{sub_magnitudes(b.magnitude, a.magnitude), sign};
+}
+
+signed_value scale_value(const signed_value& a, limb factor) {
+    signed_value result{buffer(a.magnitude.size() + 1), a.sign};
+    result.magnitude.back() = mul_1(result.magnitude.data(), a.magnitude.data(), a.magnitude.size(), factor);
+
+    if (!result.magnitude.back()) result.magnitude.pop_back();
+    return result;
+}
+
+//! Division that is known to leave no remainder
+signed_value divexact_value(signed_value a, limb divisor) {
+    divrem_1(a.magnitude.data(), a.magnitude.data(), a.magnitude.size(), divisor);
+    a.magnitude.resize(normalized_size(a.magnitude.data(), a.magnitude.size()));
+
+    if (a.magnitude.empty()) a.sign = 1;
+    return a;
+}
+
+signed_value mul_values(const signed_value& a, const signed_value& b) {
+    if (a.magnitude.empty() || b.magnitude.empty()) return signed_value{};
+
+    signed_value result{buffer(a.magnitude.size() + b.magnitude.size()), a.sign * b.sign};
+    mul(result.magnitude.data(), a.magnitude.data(), a.magnitude.size(), b.magnitude.data(), b.magnitude.size());
+
+    result.magnitude.resize(normalized_size(result.magnitude.data(), result.magnitude.size()));
+    return result;
+}
+
+//! Values of a0 + a1 x + a2 x^2 at 0, 1, -1, -2 and infinity
+void toom3_evaluate(const signed_value& a0, const signed_value& a1, const signed_value& a2, signed_value* points) {
+    signed_value even = add_values(a0, a2);
+
+    points[0] = a0;
+    points[1] = add_values(even, a1);
+    points[2] = add_values(even, a1, -1);
+    points[3] = add_values(add_values(a0, scale_value(a1, 2), -1), scale_value(a2, 4));
+    points[4] = a2;
+}
+
+//! r[0..rn) += value * B^shift for a non-negative value
+void add_shifted(limb* r, std::size_t rn, const signed_value& value, std::size_t shift) {
+    if (value.magnitude.empty()) return;
+
+    add(r + shift, r + shift, rn - shift, value.magnitude.data(), value.magnitude.size());
+}
+
+//! Splits the longer operand into pieces as long as the shorter one
+void mul_unbalanced(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    std::fill(r, r + an + bn, 0);
+
+    std::size_t pieces = (an + bn - 1) / bn;
+
+    if (thread_pool* workers = parallel_pool(bn)) {
+        std::vector<buffer> products(pieces);
+
+        {
+            task_group group(*workers);
+
+            for (std::size_t j = 0; j < pieces; j++) {
+                group.run([&, j] {
+                    std::size_t length = std::min(bn, an - j * bn);
+
+                    products[j].resize(length + bn);
+                    mul(products[j].data(), a + j * bn, length, b, bn);
+                });
+            }
+
+            group.wait();
+        }
+
+        for (std::size_t j = 0; j < pieces; j++) add(r + j * bn, r + j * bn, an + bn - j * bn, products[j].data(), products[j].size());
+        return;
+    }
+
+    buffer product(2 * bn);
+
+    for (std::size_t i = 0; i < an; i += bn) {
+        std::size_t length = std::min(bn, an - i);
+
+        mul(product.data(), a + i, length, b, bn);
+        add(r + i, r + i, an + bn - i, product.data(), length + bn);
+    }
+}
+
+//! NTT-friendly primes, each of the form c 2^k + 1 with k >= 23
+constexpr std::size_t ntt_prime1 = 998244353;
+constexpr std::size_t ntt_prime2 = 469762049;
+constexpr std::size_t ntt_prime3 = 167772161;
+
+//! The operands are cut into 30-bit pieces so that every coefficient of the
+//! product, at most 2^23 2^60, stays below ntt_prime1 ntt_prime2 ntt_prime3 ~ 2^86
+constexpr int ntt_chunk_bits = 30;
+constexpr limb ntt_chunk_mask = (limb(1) << ntt_chunk_bits) - 1;
+
+std::vector<std::uint32_t> split_chunks(const limb* a, std::size_t n) {
+    std::vector<std::uint32_t> chunks((n * limb_bits + ntt_chunk_bits - 1) / ntt_chunk_bits);
+
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+        std::size_t bit = i * ntt_chunk_bits;
+        std::size_t word = bit / limb_bits, offset = bit % limb_bits;
+
+        limb value = a[word] >> offset;
+        if (offset + ntt_chunk_bits > limb_bits && word + 1 < n) value |= a[word + 1] << (limb_bits - offset);
+
+        chunks[i] = static_cast<std::uint32_t>(value & ntt_chunk_mask);
+    }
+
+    return chunks;
+}
+
+template<std::size_t p>
+std::vector<number_field<p>> to_field(const std::vector<std::uint32_t>& chunks) {
+    std::vector<number_field<p>> result(chunks.size());
+
+    for (std::size_t i = 0; i < chunks.size(); i++) result[i] = number_field<p>(chunks[i]);
+
+    return result;
+}
+
+} // namespace
+
+void set_thread_count(std::size_t threads) {
+    requested_threads = threads;
+
+    std::lock_guard<std::mutex> guard(pool_lock);
+    shared_pool.reset();
+}
+
+std::size_t thread_count() {
+    std::size_t threads = requested_threads.load(std::memory_order_relaxed);
+    if (threads) return threads;
+
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+thread_pool* shared_thread_pool() {
+    std::size_t threads = thread_count();
+    if (threads <= 1) return nullptr;
+
+    std::lock_guard<std::mutex> guard(pool_lock);
+    if (!shared_pool || shared_pool->size() != threads - 1) shared_pool = std::make_unique<thread_pool>(threads - 1);
+
+    return shared_pool.get();
+}
+
+void set_parallel_threshold(std::size_t limbs) {
+    threshold = limbs;
+}
+
+std::size_t parallel_threshold() {
+    return threshold;
+}
+
+void mul(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+
+    if (bn < karatsuba_threshold) mul_basecase(r, a, an, b, bn);
+    else if (bn <= (an + 1) / 2) mul_unbalanced(r, a, an, b, bn);
+    else if (bn >= ntt_threshold && an + bn <= ntt_max_limbs) mul_ntt(r, a, an, b, bn);
+    else if (bn >= toom3_threshold && bn > 2 * ((an + 2) / 3)) mul_toom3(r, a, an, b, bn);
+    else mul_karatsuba(r, a, an, b, bn);
+}
+
+//! Requires an >= bn > ceil(an / 2)
+void mul_karatsuba(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    std::size_t half = (an + 1) / 2;
+    std::size_t n = an + bn;
+
+    // a = a1 B^half + a0, b = b1 B^half + b0
+    // a b = z2 B^(2 half) + ((a0 + a1)(b0 + b1) - z0 - z2) B^half + z0
+    buffer a_sum(half + 1), b_sum(half + 1);
+    a_sum[half] = add(a_sum.data(), a, half, a + half, an - half);
+    b_sum[half] = add(b_sum.data(), b, half, b + half, bn - half);
+
+    std::size_t a_sum_size = half + (a_sum[half] != 0);
+    std::size_t b_sum_size = half + (b_sum[half] != 0);
+
+    buffer middle(a_sum_size + b_sum_size);
+
+    run_tasks(bn,
+        [&] { mul(middle.data(), a_sum.data(), a_sum_size, b_sum.data(), b_sum_size); },
+        [&] { mul(r, a, half, b, half); },
+        [&] { mul(r + 2 * half, a + half, an - half, b + half, bn - half); });
+
+    sub(middle.data(), middle.data(), middle.size(), r, 2 * half);
+    sub(middle.data(), middle.data(), middle.size(), r + 2 * half, n - 2 * half);
+
+    std::size_t middle_size = normalized_size(middle.data(), middle.size());
+    add(r + half, r + half, n - half, middle.data(), middle_size);
+}
+
+//! Requires an >= bn > 2 ceil(an / 3)
+void mul_toom3(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    std::size_t k = (an + 2) / 3;
+    std::size_t n = an + bn;
+
+    signed_value p[5], q[5], w[5];
+    toom3_evaluate(make_value(a, k), make_value(a + k, k), make_value(a + 2 * k, an - 2 * k), p);
+    toom3_evaluate(make_value(b, k), make_value(b + k, k), make_value(b + 2 * k, bn - 2 * k), q);
+
+    run_tasks(bn,
+        [&] { w[0] = mul_values(p[0], q[0]); },
+        [&] { w[1] = mul_values(p[1], q[1]); },
+        [&] { w[2] = mul_values(p[2], q[2]); },
+        [&] { w[3] = mul_values(p[3], q[3]); },
+        [&] { w[4] = mul_values(p[4], q[4]); });
+
+    // Bodrato's interpolation sequence for the points 0, 1, -1, -2, infinity
+    signed_value r0 = w[0];
+    signed_value r4 = w[4];
+    signed_value r3 = divexact_value(add_values(w[3], w[1], -1), 3);
+    signed_value r1 = divexact_value(add_values(w[1], w[2], -1), 2);
+    signed_value r2 = add_values(w[2], w[0], -1);
+
+    r3 = add_values(divexact_value(add_values(r2, r3, -1), 2), scale_value(r4, 2));
+    r2 = add_values(add_values(r2, r1), r4, -1);
+    r1 = add_values(r1, r3, -1);
+
+    std::fill(r, r + n, 0);
+    add_shifted(r, n, r0, 0);
+    add_shifted(r, n, r1, k);
+    add_shifted(r, n, r2, 2 * k);
+    add_shifted(r, n, r3, 3 * k);
+    add_shifted(r, n, r4, 4 * k);
+}
+
+void mul_ntt(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn) {
+    using field1 = number_field<ntt_prime1>;
+    using field2 = number_field<ntt_prime2>;
+    using field3 = number_field<ntt_prime3>;
+
+    std::vector<std::uint32_t> a_chunks = split_chunks(a, an);
+    std::vector<std::uint32_t> b_chunks = split_chunks(b, bn);
+
+    std::vector<field1> product1;
+    std::vector<field2> product2;
+    std::vector<field3> product3;
+
+    // The three primes are independent transforms
+    run_tasks(std::min(an, bn),
+        [&] { product1 = convolution(to_field<ntt_prime1>(a_chunks), to_field<ntt_prime1>(b_chunks)); },
+        [&] { product2 = convolution(to_field<ntt_prime2>(a_chunks), to_field<ntt_prime2>(b_chunks)); },
+        [&] { product3 = convolution(to_field<ntt_prime3>(a_chunks), to_field<ntt_prime3>(b_chunks)); });
+
+    // Garner's algorithm: x = x1 + p1 t2 + p1 p2 t3
+    const field2 inverse1 = field2(ntt_prime1).inverse();
+    const field3 inverse12 = (field3(ntt_prime1) * field3(ntt_prime2)).inverse();
+
+    std::size_t n = an + bn;
+    std::fill(r, r + n, 0);
+
+    dlimb carry = 0;
+
+    for (std::size_t i = 0; i < product1.size() || carry; i++) {
+        if (i < product1.size()) {
+            limb x1 = product1[i].get_number();
+
+            limb t2 = ((product2[i] - field2(x1)) * inverse1).get_number();
+            limb x12 = x1 + ntt_prime1 * t2;
+
+            limb t3 = ((product3[i] - field3(x12)) * inverse12).get_number();
+            carry += x12 + static_cast<dlimb>(ntt_prime1 * ntt_prime2) * t3;
+        }
+
+        limb digit = static_cast<limb>(carry) & ntt_chunk_mask;
+        carry >>= ntt_chunk_bits;
+
+        std::size_t bit = i * ntt_chunk_bits;
+        std::size_t word = bit / limb_bits, offset = bit % limb_bits;
+
+        if (word >= n) break;
+
+        r[word] |= digit << offset;
+        if (offset + ntt_chunk_bits > limb_bits && word + 1 < n) r[word + 1] |= digit >> (limb_bits - offset);
+    }
+}
+
+} // namespace limbs
@@ -0,0 +1,365 @@
+#include "Bigint.h"
+#include "../Number field of prime order/Modular.h"
+#include "../Number field of prime order/Modular.cpp"
+
+#include <bitset>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using limb = bigint::limb;
+using dlimb = limbs::dlimb;
+
+//! Roots of at most this many bits come straight from a floating-point estimate
+constexpr std::size_t estimate_bits = 48;
+
+std::size_t bit_length(const bigint& x) {
+    const limb_buffer& digits = x._limbs();
+    return digits.empty() ? 0 : digits.size() * limbs::limb_bits - __builtin_clzll(digits.back());
+}
+
+std::size_t trailing_zeros(const bigint& x) {
+    const limb_buffer& digits = x._limbs();
+    std::size_t i = 0;
+
+    while (!digits[i]) i++;
+    return i * limbs::limb_bits + __builtin_ctzll(digits[i]);
+}
+
+//! x >> bits for x >= 0
+bigint shift_down(const bigint& x, std::size_t bits) {
+    const limb_buffer& digits = x._limbs();
+    std::size_t skip = bits / limbs::limb_bits;
+    int shift = bits % limbs::limb_bits;
+
+    bigint result;
+    if (skip >= digits.size()) return result;
+
+    limb_buffer& r = result._limbs();
+    r = limb_buffer(digits.begin() + skip, digits.end());
+    if (shift) limbs::rshift(r.data(), r.data(), r.size(), shift);
+
+    result.trim_zeros();
+    return result;
+}
+
+//! x << bits for x >= 0
+bigint shift_up(const bigint& x, std::size_t bits) {
+    const limb_buffer& digits = x._limbs();
+    std::size_t skip = bits / limbs::limb_bits;
+    int shift = bits % limbs::limb_bits;
+
+    bigint result;
+    if (digits.empty()) return result;
+
+    limb_buffer& r = result._limbs();
+    r.resize(digits.size() + skip + 1);
+
+    if (shift) r.back() = limbs::lshift(r.data() + skip, digits.data(), digits.size(), shift);
+    else std::copy(digits.begin(), digits.end(), r.begin() + skip);
+
+    result.trim_zeros();
+    return result;
+}
+
+bigint power(const bigint& base, std::size_t exponent) {
+    bigint result = 1, square = base;
+
+    for (; exponent; exponent >>= 1) {
+        if (exponent & 1) result *= square;
+        if (exponent > 1) square *= square;
+    }
+
+    return result;
+}
+
+//! log2 of x > 0 from its leading 128 bits
+long double log2_of(const bigint& x) {
+    const limb_buffer& digits = x._limbs();
+    std::size_t n = digits.size();
+
+    long double leading = digits[n - 1];
+    if (n > 1) leading = std::ldexp(leading, limbs::limb_bits) + digits[n - 2];
+
+    return std::log2(leading) + static_cast<long double>(n > 1 ? (n - 2) * limbs::limb_bits : 0);
+}
+
+//! Nearest integer to x^(1/n) for a root below 2^estimate_bits, off by at most one
+limb estimate_root(long double log2_x, std::size_t n) {
+    return static_cast<limb>(std::llround(std::exp2(log2_x / n)));
+}
+
+//! Floor of the n-th root of x > 0 for n >= 2 by Newton's iteration with precision doubling:
+//! the root of the leading bits, computed to half the final precision, bounds the root from
+//! above, and from such a bound the iteration falls monotonically to the floor in one or two
+//! steps. Every level costs a few products and a division at its own size, so the whole is
+//! within a constant factor of one multiplication
+bigint root_floor(const bigint& x, std::size_t n) {
+    std::size_t root_bits = (bit_length(x) + n - 1) / n;
+
+    if (root_bits <= estimate_bits) {
+        bigint root = static_cast<long long>(estimate_root(log2_of(x), n));
+
+        while (root && power(root, n) > x) root--;
+        while (power(root + 1, n) <= x) root++;
+
+        return root;
+    }
+
+    // x < (high + 1) 2^(n t) gives x^(1/n) < (high^(1/n) + 1) 2^t
+    std::size_t t = root_bits / 2;
+    bigint root = shift_up(root_floor(shift_down(x, n * t), n) + 1, t);
+
+    bigint scale = static_cast<long long>(n), previous = static_cast<long long>(n - 1);
+
+    while (true) {
+        bigint next = (previous * root + x / power(root, n - 1)) / scale;
+        if (next >= root) return root;
+
+        root = std::move(next);
+    }
+}
+
+//! Which residues are squares, modulo 64 and the factors 65535 and 641 of 2^64 - 1
+struct square_residues {
+    std::bitset<64> mod_64;
+    std::bitset<65535> mod_65535;
+    std::bitset<641> mod_641;
+};
+
+const square_residues& squares() {
+    static const square_residues tables = [] {
+        square_residues result;
+
+        for (std::size_t i = 0; i < 64; i++) result.mod_64[i * i % 64] = true;
+        for (std::size_t i = 0; i < 65535; i++) result.mod_65535[i * i % 65535] = true;
+        for (std::size_t i = 0; i < 641; i++) result.mod_641[i * i % 641] = true;
+
+        return result;
+    }();
+
+    return tables;
+}
+
+//! False if x > 0 is certainly no square. Passes about one non-square in 250
+bool square_filter(const bigint& x) {
+    const limb_buffer& digits = x._limbs();
+    const square_residues& tables = squares();
+
+    if (!tables.mod_64[digits[0] % 64]) return false;
+
+    // Summing the limbs with end-around carry gives x mod 2^64 - 1 in one pass
+    limb sum = 0;
+    for (limb digit : digits) {
+        sum += digit;
+        if (sum < digit) sum++;
+    }
+
+    return tables.mod_65535[sum % 65535] && tables.mod_641[sum % 641];
+}
+
+//! Modulo a prime q = 1 mod p only one unit in p is a p-th power, so a few such q reject
+//! almost every x that is no p-th power. Their product stays below 2^64, so that one
+//! remainder serves them all
+struct residue_filter {
+    std::size_t p;
+    std::vector<limb> primes;
+    limb product;
+};
+
+residue_filter make_filter(std::size_t p) {
+    residue_filter filter{p, {}, 1};
+
+    for (limb q = 2 * p + 1; filter.primes.size() < 3 && q < (limb(1) << 32); q += 2 * p) {
+        if (!modular::is_prime(q)) continue;
+        if (static_cast<dlimb>(filter.product) * q >> limbs::limb_bits) break;
+
+        filter.primes.push_back(q);
+        filter.product *= q;
+    }
+
+    return filter;
+}
+
+//! False if the x with x mod filter.product = residue is certainly no p-th power
+bool passes(const residue_filter& filter, limb residue) {
+    for (limb q : filter.primes) {
+        limb r = residue % q;
+        if (r && modular::power(r, (q - 1) / filter.p, q) != 1) return false;
+    }
+
+    return true;
+}
+
+//! x mod m for every m in moduli, from one remainder tree over their products:
+//! a division at the root and ever smaller ones further down, instead of a pass over x per modulus
+std::vector<limb> remainders(const bigint& x, const std::vector<limb>& moduli) {
+    if (moduli.empty()) return {};
+
+    std::vector<std::vector<bigint>> tree(1);
+
+    for (limb modulus : moduli) {
+        bigint leaf;
+        leaf._limbs().resize(1);
+        leaf._limbs()[0] = modulus;
+
+        tree[0].push_back(std::move(leaf));
+    }
+
+    while (tree.back().size() > 1) {
+        const std::vector<bigint>& level = tree.back();
+        std::vector<bigint> products;
+
+        for (std::size_t i = 0; i + 1 < level.size(); i += 2) products.push_back(level[i] * level[i + 1]);
+        if (level.size() % 2) products.push_back(level.back());
+
+        tree.push_back(std::move(products));
+    }
+
+    std::vector<bigint> current{x % tree.back()[0]};
+
+    for (std::size_t depth = tree.size() - 1; depth-- > 0;) {
+        const std::vector<bigint>& level = tree[depth];
+        std::vector<bigint> below(level.size());
+
+        for (std::size_t i = 0; i < level.size(); i++) below[i] = current[i / 2] % level[i];
+
+        current = std::move(below);
+    }
+
+    std::vector<limb> result(moduli.size());
+    for (std::size_t i = 0; i < moduli.size(); i++) result[i] = (current[i] ? current[i]._limbs()[0] : 0);
+
+    return result;
+}
+
+//! The p-th root of x > 1 if it is exact and below 2^estimate_bits. log2_x is log2_of(x)
+bool estimated_root(const bigint& x, std::size_t p, long double log2_x, bigint& root) {
+    limb candidate = estimate_root(log2_x, p);
+    if (candidate < 2) return false;
+
+    // Cheap check modulo 2^64 before the real power
+    limb low = 1, square = candidate;
+    for (std::size_t e = p; e; e >>= 1) {
+        if (e & 1) low *= square;
+        square *= square;
+    }
+
+    if (low != x._limbs()[0]) return false;
+
+    root = static_cast<long long>(candidate);
+    return power(root, p) == x;
+}
+
+//! {r, k} with x = r^k for x > 1 and the largest such k
+std::pair<bigint, std::size_t> largest_power(const bigint& x) {
+    std::size_t bits = bit_length(x), zeros = trailing_zeros(x);
+    long double log2_x = log2_of(x);
+
+    // Prime exponents p: x = r^p with r >= 2 needs p < bits, and p has to divide the number of trailing zeros
+    std::vector<std::size_t> exponents;
+    std::vector<bool> composite(bits, false);
+
+    for (std::size_t p = 2; p < bits; p++) {
+        if (composite[p]) continue;
+        for (std::size_t multiple = p * p; multiple < bits; multiple += p) composite[multiple] = true;
+
+        if (!zeros || zeros % p == 0) exponents.push_back(p);
+    }
+
+    // The odd exponents whose roots are too long to estimate get a residue filter first
+    std::vector<residue_filter> filters;
+    std::vector<limb> moduli;
+
+    for (std::size_t p : exponents) {
+        if (p == 2 || (bits + p - 1) / p <= estimate_bits) continue;
+
+        filters.push_back(make_filter(p));
+        moduli.push_back(filters.back().product);
+    }
+
+    std::vector<limb> residues = remainders(x, moduli);
+    std::size_t filtered = 0;
+
+    for (std::size_t p : exponents) {
+        bigint root;
+        bool exact;
+
+        if ((bits + p - 1) / p <= estimate_bits) {
+            exact = estimated_root(x, p, log2_x, root);
+        }
+        else {
+            bool possible = (p == 2 ? square_filter(x) : passes(filters[filtered], residues[filtered]));
+            if (p != 2) filtered++;
+
+            if (!possible) continue;
+
+            root = root_floor(x, p);
+            exact = (power(root, p) == x);
+        }
+
+        if (!exact) continue;
+
+        // x = s^k is a p-th power exactly when p | k, so the rest of the exponent is in the root
+        std::pair<bigint, std::size_t> rest = largest_power(root);
+        return {std::move(rest.first), rest.second * p};
+    }
+
+    return {x, 1};
+}
+
+} // namespace
+
+bigint isqrt(const bigint& self) {
+    if (self._sign() < 0) throw std::invalid_argument("isqrt: negative argument");
+    if (!self) return self;
+
+    return root_floor(self, 2);
+}
+
+bigint iroot(const bigint& self, std::size_t n) {
+    if (!n) throw std::invalid_argument("iroot: zeroth root");
+    if (n == 1 || !self) return self;
+
+    if (self._sign() < 0) {
+        if (n % 2 == 0) throw std::invalid_argument("iroot: even root of a negative number");
+        return -root_floor(-self, n);
+    }
+
+    return root_floor(self, n);
+}
+
+bool is_perfect_square(const bigint& self) {
+    if (self._sign() < 0) return false;
+    if (!self) return true;
+    if (!square_filter(self)) return false;
+
+    bigint root = isqrt(self);
+    return root * root == self;
+}
+
+std::pair<bigint, std::size_t> perfect_power(const bigint& self) {
+    if (self._limbs().size() == 1 && self._limbs()[0] == 1) return {self, 1};
+    if (!self) return {self, 1};
+
+    if (self._sign() > 0) return largest_power(self);
+
+    // -(r^k) = (-r^(2^e))^o for k = 2^e o with o odd, odd exponents only
+    std::pair<bigint, std::size_t> magnitude = largest_power(-self);
+    std::size_t odd = magnitude.second, even = 1;
+
+    while (odd % 2 == 0) {
+        odd /= 2;
+        even *= 2;
+    }
+
+    if (odd == 1) return {self, 1};
+    return {-power(magnitude.first, even), odd};
+}
+
+bool is_perfect_power(const bigint& self) {
+    if (!self || (self._limbs().size() == 1 && self._limbs()[0] == 1)) return true;
+
+    return perfect_power(self).second > 1;
+}
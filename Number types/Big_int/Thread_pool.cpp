@@ -0,0 +1,143 @@
+#include "Thread_pool.h"
+
+namespace {
+
+//! The pool the current thread works for and its queue there
+thread_local const thread_pool* owner = nullptr;
+thread_local std::size_t own_queue = 0;
+
+} // namespace
+
+//! thread_pool
+
+thread_pool::thread_pool(std::size_t threads): pending(0), stopping(false) {
+    for (std::size_t i = 0; i <= threads; i++) queues.push_back(std::make_unique<queue>());
+
+    for (std::size_t i = 0; i < threads; i++) workers.emplace_back(&thread_pool::work, this, i);
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void thread_pool::work(std::size_t index) {
+    owner = this;
+    own_queue = index;
+
+    std::function<void()> task;
+
+    while (true) {
+        if (take(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [this] { return stopping || pending.load() > 0; });
+
+        if (stopping) return;
+    }
+}
+
+bool thread_pool::take(std::size_t index, std::function<void()>& task) {
+    if (!pending.load()) return false;
+
+    // Newest own task first, then the oldest task of someone else
+    {
+        queue& own = *queues[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending--;
+            return true;
+        }
+    }
+
+    for (std::size_t i = 1; i < queues.size(); i++) {
+        queue& victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::size_t thread_pool::size() const {
+    return workers.size();
+}
+
+void thread_pool::submit(std::function<void()> task) {
+    queue& target = *queues[owner == this ? own_queue : queues.size() - 1];
+    pending++;
+
+    {
+        std::lock_guard<std::mutex> guard(target.lock);
+        target.tasks.push_back(std::move(task));
+    }
+
+    // A worker that has just seen pending == 0 is either still holding sleep_lock or already waiting
+    { std::lock_guard<std::mutex> guard(sleep_lock); }
+    wake.notify_one();
+}
+
+bool thread_pool::run_one() {
+    std::function<void()> task;
+    if (!take(owner == this ? own_queue : queues.size() - 1, task)) return false;
+
+    task();
+    return true;
+}
+
+//! task_group
+
+task_group::task_group(thread_pool& pool): pool(pool), remaining(0) {}
+
+task_group::~task_group() {
+    while (remaining.load()) {
+        if (!pool.run_one()) std::this_thread::yield();
+    }
+}
+
+void task_group::run(std::function<void()> task) {
+    remaining++;
+
+    pool.submit([this, task = std::move(task)] {
+        try {
+            task();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> guard(error_lock);
+            if (!error) error = std::current_exception();
+        }
+
+        // Last access to the group, wait() may return and destroy it right after
+        remaining--;
+    });
+}
+
+void task_group::wait() {
+    while (remaining.load()) {
+        if (!pool.run_one()) std::this_thread::yield();
+    }
+
+    if (error) {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
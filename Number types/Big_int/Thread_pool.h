@@ -0,0 +1,82 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! Work-stealing pool for fork-join parallelism inside bigint algorithms.
+//!
+//! Every worker owns a deque: it pushes and pops its own tasks at the back, so a
+//! recursion unfolds depth-first and stays in cache, while idle workers steal from
+//! the front, where the largest pending subproblems sit. A thread that waits for
+//! its subtasks runs queued work meanwhile, so nested task groups never deadlock:
+//!
+//!     task_group group(pool);
+//!     group.run([&] { left(); });
+//!     right();
+//!     group.wait();
+class thread_pool {
+private:
+    struct queue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<queue>> queues; // one per worker, plus one for outside threads
+    std::vector<std::thread> workers;
+
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    std::atomic<std::size_t> pending;
+    bool stopping;
+
+    void work(std::size_t index);
+    bool take(std::size_t index, std::function<void()>& task);
+public:
+    //! Rule of five
+    explicit thread_pool(std::size_t threads);
+    thread_pool(const thread_pool& other) = delete;
+    ~thread_pool();
+
+    thread_pool& operator=(const thread_pool& other) = delete;
+
+    //! Methods
+
+    std::size_t size() const;
+
+    void submit(std::function<void()> task);
+
+    //! Runs one queued task on the calling thread, false if there was none
+    bool run_one();
+};
+
+//! Tasks that are waited for together. Exceptions thrown by them are rethrown by wait()
+class task_group {
+private:
+    thread_pool& pool;
+    std::atomic<std::size_t> remaining;
+    std::mutex error_lock;
+    std::exception_ptr error;
+public:
+    //! Rule of five
+    explicit task_group(thread_pool& pool);
+    task_group(const task_group& other) = delete;
+    ~task_group();
+
+    task_group& operator=(const task_group& other) = delete;
+
+    //! Methods
+
+    void run(std::function<void()> task);
+    void wait();
+};
+
+#endif // THREAD_POOL_H
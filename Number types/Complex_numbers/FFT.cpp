@@ -0,0 +1,259 @@
+#include "FFT.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+template<typename vt>
+const complex<vt>* fft_twiddles(int bits) {
+    using table = std::vector<complex<vt>>;
+
+    // Tables only ever grow, and the outgrown ones are kept, so a pointer handed out stays valid
+    static std::mutex lock;
+    static std::vector<std::unique_ptr<table>> tables;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (tables.empty() || tables.back()->size() < (std::size_t(1) << bits)) {
+        auto result = std::make_unique<table>(std::size_t(1) << bits);
+        const vt pi = std::acos(vt(-1));
+
+        for (int k = 1; k <= bits; k++) {
+            std::size_t half = std::size_t(1) << (k - 1);
+            complex<vt>* w = result->data() + half;
+
+            // The second half of the first half is the first one times -i, exactly
+            std::size_t quarter = (half + 1) / 2;
+            vt angle = -2 * pi / vt(2 * half);
+
+            for (std::size_t j = 0; j < quarter; j++) w[j] = complex<vt>(std::cos(angle * vt(j)), std::sin(angle * vt(j)));
+            for (std::size_t j = quarter; j < half; j++) w[j] = complex<vt>(w[j - quarter]._imag(), -w[j - quarter]._real());
+        }
+
+        tables.push_back(std::move(result));
+    }
+
+    return tables.back()->data();
+}
+
+//! The least bits with n <= 2^bits
+inline int fft_bits(std::size_t n) {
+    int bits = 0;
+    while ((std::size_t(1) << bits) < n) bits++;
+
+    return bits;
+}
+
+//! i z, or -i z for the inverse transform
+template<typename vt, bool inverse>
+complex<vt> rotate(const complex<vt>& z) {
+    if constexpr (inverse) return complex<vt>(z._imag(), -z._real());
+    else return complex<vt>(-z._imag(), z._real());
+}
+
+//! A radix-4 pass of the sequences of length n interleaved with stride s, x into y: the four
+//! quarters of each, at s p + q for p < n / 4, become the outputs 4p to 4p + 3, so the next pass
+//! sees sequences of length n / 4 with stride 4 s. The inner loop runs over q, consecutive in both
+template<typename vt, bool inverse>
+void stockham_pass(const complex<vt>* x, complex<vt>* y, std::size_t n, std::size_t s, const complex<vt>* table) {
+    std::size_t m = n / 4;
+
+    for (std::size_t p = 0; p < m; p++) {
+        // w^3p past the table of this pass, at 3p >= n / 2, is -w^(3p - n / 2), exactly
+        complex<vt> w1 = table[n / 2 + p], w2 = table[n / 4 + p];
+        complex<vt> w3 = (3 * p < n / 2 ? table[n / 2 + 3 * p] : -table[3 * p]);
+
+        if constexpr (inverse) {
+            w1 = w1.conjugate();
+            w2 = w2.conjugate();
+            w3 = w3.conjugate();
+        }
+
+        const complex<vt>* a = x + s * p;
+        complex<vt>* b = y + s * 4 * p;
+
+        for (std::size_t q = 0; q < s; q++) {
+            complex<vt> sum02 = a[q] + a[q + 2 * s * m], difference02 = a[q] - a[q + 2 * s * m];
+            complex<vt> sum13 = a[q + s * m] + a[q + 3 * s * m];
+            complex<vt> difference13 = rotate<vt, inverse>(a[q + s * m] - a[q + 3 * s * m]);
+
+            b[q] = sum02 + sum13;
+            b[q + s] = (difference02 - difference13) * w1;
+            b[q + 2 * s] = (sum02 - sum13) * w2;
+            b[q + 3 * s] = (difference02 + difference13) * w3;
+        }
+    }
+}
+
+//! The unscaled transform of values, of 2^bits elements, with work as the other buffer
+template<typename vt, bool inverse>
+void stockham(std::vector<complex<vt>>& values, std::vector<complex<vt>>& work, int bits) {
+    std::size_t n = values.size();
+    if (n <= 1) return;
+
+    const complex<vt>* table = fft_twiddles<vt>(bits);
+    work.resize(n);
+
+    std::size_t length = n, stride = 1;
+
+    for (; length >= 4; length /= 4, stride *= 4) {
+        stockham_pass<vt, inverse>(values.data(), work.data(), length, stride, table);
+        std::swap(values, work);
+    }
+
+    // An odd number of radix-2 stages leaves one of length 2, whose only twiddle is 1
+    if (length == 2) {
+        for (std::size_t q = 0; q < stride; q++) {
+            work[q] = values[q] + values[q + stride];
+            work[q + stride] = values[q] - values[q + stride];
+        }
+
+        std::swap(values, work);
+    }
+}
+
+template<typename vt>
+void fft(std::vector<complex<vt>>& values, bool inverse) {
+    if (values.size() & (values.size() - 1)) throw std::invalid_argument("fft: the length must be a power of two");
+
+    int bits = fft_bits(values.size());
+    std::vector<complex<vt>> work;
+
+    if (!inverse) {
+        stockham<vt, false>(values, work, bits);
+        return;
+    }
+
+    stockham<vt, true>(values, work, bits);
+
+    vt scale = vt(1) / vt(values.size());
+    for (complex<vt>& value : values) value = complex<vt>(value._real() * scale, value._imag() * scale);
+}
+
+template<typename vt>
+std::vector<complex<vt>> convolution(std::vector<complex<vt>> a, std::vector<complex<vt>> b) {
+    if (a.empty() || b.empty()) return {};
+
+    std::size_t result_size = a.size() + b.size() - 1;
+    int bits = fft_bits(result_size);
+    std::size_t n = std::size_t(1) << bits;
+    std::vector<complex<vt>> work;
+
+    a.resize(n);
+    b.resize(n);
+
+    stockham<vt, false>(a, work, bits);
+    stockham<vt, false>(b, work, bits);
+
+    // The 1 / n of the inverse transform goes with the pointwise product
+    vt scale = vt(1) / vt(n);
+
+    for (std::size_t i = 0; i < n; i++) {
+        complex<vt> product = a[i] * b[i];
+        a[i] = complex<vt>(product._real() * scale, product._imag() * scale);
+    }
+
+    stockham<vt, true>(a, work, bits);
+    a.resize(result_size);
+
+    return a;
+}
+
+template<typename vt, typename>
+std::vector<vt> convolution(const std::vector<vt>& a, const std::vector<vt>& b) {
+    if (a.empty() || b.empty()) return {};
+
+    std::size_t result_size = a.size() + b.size() - 1;
+    int bits = fft_bits(result_size);
+    std::size_t n = std::size_t(1) << bits;
+    std::vector<complex<vt>> z(n), work;
+
+    for (std::size_t i = 0; i < a.size(); i++) z[i] = complex<vt>(a[i], z[i]._imag());
+    for (std::size_t i = 0; i < b.size(); i++) z[i] = complex<vt>(z[i]._real(), b[i]);
+
+    stockham<vt, false>(z, work, bits);
+
+    // With Z the transform of a + ib, those of a and b are (Z_k + conj Z_-k) / 2 and
+    // (Z_k - conj Z_-k) / 2i, whose product is (Z_k^2 - conj Z_-k^2) / 4i. The pairs k, -k are
+    // replaced together, with the 1 / n of the inverse transform
+    vt scale = vt(1) / vt(4 * n);
+
+    for (std::size_t k = 0; k <= n / 2; k++) {
+        std::size_t j = (n - k) & (n - 1);
+
+        complex<vt> zk = z[k], zj = z[j];
+        complex<vt> zk_conjugate = zk.conjugate(), zj_conjugate = zj.conjugate();
+
+        complex<vt> pk = zk * zk - zj_conjugate * zj_conjugate;
+        complex<vt> pj = zj * zj - zk_conjugate * zk_conjugate;
+
+        // x / 4i = -i x / 4
+        z[k] = complex<vt>(pk._imag() * scale, -pk._real() * scale);
+        z[j] = complex<vt>(pj._imag() * scale, -pj._real() * scale);
+    }
+
+    stockham<vt, true>(z, work, bits);
+
+    std::vector<vt> result(result_size);
+    for (std::size_t i = 0; i < result_size; i++) result[i] = z[i]._real();
+
+    return result;
+}
+
+//! Percival's factor for a transform of length n, see FFT.h
+template<typename vt>
+vt fft_error_factor(std::size_t n) {
+    vt u = std::numeric_limits<vt>::epsilon() / 2;
+    vt k = vt(fft_bits(n));
+
+    return std::pow(1 + u, 3 * k) * std::pow(1 + u * std::sqrt(vt(5)), 3 * k + 1) * std::pow(1 + 2 * u, 3 * k) - 1;
+}
+
+template<typename vt>
+vt convolution_error_bound(const std::vector<complex<vt>>& a, const std::vector<complex<vt>>& b) {
+    if (a.empty() || b.empty()) return 0;
+
+    vt a_norm = 0, b_norm = 0;
+
+    for (const complex<vt>& x : a) a_norm += x._real() * x._real() + x._imag() * x._imag();
+    for (const complex<vt>& x : b) b_norm += x._real() * x._real() + x._imag() * x._imag();
+
+    return std::sqrt(a_norm) * std::sqrt(b_norm) * fft_error_factor<vt>(a.size() + b.size() - 1);
+}
+
+template<typename vt, typename>
+vt convolution_error_bound(const std::vector<vt>& a, const std::vector<vt>& b) {
+    if (a.empty() || b.empty()) return 0;
+
+    vt norms = 0;
+
+    for (vt x : a) norms += x * x;
+    for (vt x : b) norms += x * x;
+
+    return norms / 2 * fft_error_factor<vt>(a.size() + b.size() - 1);
+}
+
+//! The common part of the two polynomial products
+template<typename T>
+polynomial<T> fft_product(const polynomial<T>& self, const polynomial<T>& other) {
+    if (std::min(self.coef().size(), other.coef().size()) < fft_polynomial_threshold) return schoolbook_product(self, other);
+
+    polynomial<T> result(T(0));
+    result.coef() = convolution(self.coef(), other.coef());
+
+    while (result.coef().size() > 1 && result.coef().back() == T(0)) result.coef().pop_back();
+
+    return result;
+}
+
+inline polynomial<double> operator*(const polynomial<double>& self, const polynomial<double>& other) {
+    return fft_product(self, other);
+}
+
+inline polynomial<complex<double>> operator*(const polynomial<complex<double>>& self, const polynomial<complex<double>>& other) {
+    return fft_product(self, other);
+}
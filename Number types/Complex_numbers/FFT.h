@@ -0,0 +1,55 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "Complex.h"
+#include "../../Polynomials/Polynomial.h"
+
+//! Fast Fourier transform over complex<vt> for a floating-point vt, by Stockham's autosort
+//! algorithm: radix-4 passes that read and write with unit stride between two buffers, so the
+//! result comes out in order with no bit-reversal permutation. The length must be a power of two.
+//! Users include Complex.cpp, Polynomial.cpp and FFT.cpp
+
+//! The twiddles w^j of every pass of a transform of 2^bits elements, w^j at [m / 2 + j] for the
+//! root w = exp(-2 pi i / m) of a pass of length m, j < m / 2. Each one comes from std::cos and
+//! std::sin, not from products of others, so they are all accurate to an ulp. Computed at the
+//! first transform of that length and shared from then on
+template<typename vt>
+const complex<vt>* fft_twiddles(int bits);
+
+//! The transform in order, sum x_j exp(-2 pi i jk / n), or its inverse, scaled by 1 / n
+template<typename vt>
+void fft(std::vector<complex<vt>>& values, bool inverse = false);
+
+//! Acyclic convolution of a and b, the result has a.size() + b.size() - 1 elements
+template<typename vt>
+std::vector<complex<vt>> convolution(std::vector<complex<vt>> a, std::vector<complex<vt>> b);
+
+//! The same for real sequences, which are packed into a single complex one, a + ib, so that a
+//! forward and an inverse transform of that length do it, rather than three
+template<typename vt, typename = std::enable_if_t<std::is_floating_point_v<vt>>>
+std::vector<vt> convolution(const std::vector<vt>& a, const std::vector<vt>& b);
+
+//! Bounds on the largest error of a coefficient of convolution(a, b) over the exact result, by
+//! Percival's analysis of the floating-point FFT: |a|_2 |b|_2 ((1 + u)^3k (1 + u sqrt 5)^(3k + 1)
+//! (1 + t)^3k - 1) for k passes of radix 2, the unit roundoff u and the twiddle error t = 2u.
+//! The packed real convolution has (|a|_2^2 + |b|_2^2) / 2 in place of |a|_2 |b|_2
+template<typename vt>
+vt convolution_error_bound(const std::vector<complex<vt>>& a, const std::vector<complex<vt>>& b);
+
+template<typename vt, typename = std::enable_if_t<std::is_floating_point_v<vt>>>
+vt convolution_error_bound(const std::vector<vt>& a, const std::vector<vt>& b);
+
+//! Polynomials with at least this many coefficients each are multiplied by convolution
+constexpr std::size_t fft_polynomial_threshold = 64;
+
+//! Products of polynomials over double and complex<double>, which take over from the generic
+//! one of Polynomial.cpp, and fall back to schoolbook_product for short factors. The
+//! coefficients carry the rounding errors bounded by convolution_error_bound
+inline polynomial<double> operator*(const polynomial<double>& self, const polynomial<double>& other);
+inline polynomial<complex<double>> operator*(const polynomial<complex<double>>& self, const polynomial<complex<double>>& other);
+
+#endif // FFT_H
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <random>
+#include "Complex.h"
+#include "Complex.cpp"
+#include "../../Polynomials/Polynomial.cpp"
+#include "FFT.h"
+#include "FFT.cpp"
+
+//! The largest difference between the coefficients of two polynomials
+double distance(const polynomial<double>& f, const polynomial<double>& g) {
+    double result = 0;
+    if (f.coef().size() != g.coef().size()) return 1e300;
+
+    for (std::size_t i = 0; i < f.coef().size(); i++) result = std::max(result, std::abs(f[i] - g[i]));
+
+    return result;
+}
+
+double distance(const polynomial<complex<double>>& f, const polynomial<complex<double>>& g) {
+    double result = 0;
+    if (f.coef().size() != g.coef().size()) return 1e300;
+
+    for (std::size_t i = 0; i < f.coef().size(); i++) {
+        complex<double> difference = f[i] - g[i];
+        result = std::max(result, std::hypot(difference._real(), difference._imag()));
+    }
+
+    return result;
+}
+
+//! The transform against the sum that defines it, in long double
+bool check_transform(std::size_t n) {
+    std::mt19937_64 random(n);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    std::vector<complex<double>> values(n);
+    for (auto& x : values) x = complex<double>(uniform(random), uniform(random));
+
+    std::vector<complex<double>> transform = values;
+    fft(transform);
+
+    const long double pi = std::acos(-1.0L);
+    double error = 0;
+
+    for (std::size_t k = 0; k < n; k++) {
+        long double real = 0, imag = 0;
+
+        for (std::size_t j = 0; j < n; j++) {
+            long double angle = -2 * pi * static_cast<long double>(j * k % n) / n;
+            real += values[j]._real() * std::cos(angle) - values[j]._imag() * std::sin(angle);
+            imag += values[j]._real() * std::sin(angle) + values[j]._imag() * std::cos(angle);
+        }
+
+        error = std::max(error, double(std::hypot(real - transform[k]._real(), imag - transform[k]._imag())));
+    }
+
+    fft(transform, true);
+
+    polynomial<complex<double>> f(values), g(transform);
+    return error < 1e-12 * n && distance(f, g) < 1e-13;
+}
+
+bool check_real_product(std::size_t a_size, std::size_t b_size) {
+    std::mt19937_64 random(a_size * 1000003 + b_size);
+    std::vector<double> a(a_size), b(b_size);
+
+    // Integers, whose products the double loop finds exactly
+    for (auto& x : a) x = double(random() % 2001) - 1000;
+    for (auto& x : b) x = double(random() % 2001) - 1000;
+
+    polynomial<double> f(a), g(b);
+    return distance(f * g, schoolbook_product(f, g)) <= convolution_error_bound(a, b);
+}
+
+bool check_complex_product(std::size_t a_size, std::size_t b_size) {
+    std::mt19937_64 random(a_size * 1000003 + b_size);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<complex<double>> a(a_size), b(b_size);
+
+    for (auto& x : a) x = complex<double>(uniform(random), uniform(random));
+    for (auto& x : b) x = complex<double>(uniform(random), uniform(random));
+
+    polynomial<complex<double>> f(a), g(b);
+
+    // The double loop has rounding errors of its own, far below the bound
+    return distance(f * g, schoolbook_product(f, g)) <= 2 * convolution_error_bound(a, b);
+}
+
+int main() {
+    std::cout << "transform of 1: " << check_transform(1) << std::endl;
+    std::cout << "transform of 2: " << check_transform(2) << std::endl;
+    std::cout << "transform of 512: " << check_transform(512) << std::endl;
+    std::cout << "transform of 2048: " << check_transform(2048) << std::endl;
+
+    std::cout << "real product: " << check_real_product(1000, 700) << std::endl;
+    std::cout << "real product: " << check_real_product(64, 4097) << std::endl;
+    std::cout << "complex product: " << check_complex_product(1000, 700) << std::endl;
+    std::cout << "complex product: " << check_complex_product(65, 300) << std::endl;
+}
@@ -0,0 +1,461 @@
+#include "Fixed_int.h"
+
+#include <stdexcept>
+
+//! Rule of five
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>::fixed_integer(): limbs{} {}
+
+template<std::size_t Bits, bool Signed>
+template<typename I, typename>
+constexpr fixed_integer<Bits, Signed>::fixed_integer(I value): limbs{} {
+    limb extension = (std::is_signed_v<I> && value < 0 ? ~limb(0) : 0);
+
+    limbs[0] = static_cast<limb>(value);
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 1; i < limb_count; i++) limbs[i] = extension;
+}
+
+template<std::size_t Bits, bool Signed>
+template<std::size_t OtherBits, bool OtherSigned>
+constexpr fixed_integer<Bits, Signed>::fixed_integer(const fixed_integer<OtherBits, OtherSigned>& other): limbs{} {
+    constexpr std::size_t common = (limb_count < OtherBits / 64 ? limb_count : OtherBits / 64);
+    limb extension = (other.negative() ? ~limb(0) : 0);
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) limbs[i] = (i < common ? other._limbs()[i] : extension);
+}
+
+template<std::size_t Bits, bool Signed>
+fixed_integer<Bits, Signed>::fixed_integer(const std::string& value): limbs{} {
+    std::size_t i = 0;
+    bool minus = false;
+
+    if (i < value.size() && (value[i] == '+' || value[i] == '-')) minus = (value[i++] == '-');
+    if (i == value.size()) throw std::invalid_argument("fixed_integer: not a decimal number");
+
+    for (; i < value.size(); i++) {
+        if (value[i] < '0' || value[i] > '9') throw std::invalid_argument("fixed_integer: not a decimal number");
+
+        *this *= 10;
+        *this += value[i] - '0';
+    }
+
+    if (minus) *this = -*this;
+}
+
+//! Private methods
+
+template<std::size_t Bits, bool Signed>
+constexpr void fixed_integer<Bits, Signed>::divide(const limb_array& u, const limb_array& v, limb_array& q, limb_array& r) {
+    std::size_t n = limb_count;
+    while (!v[n - 1]) n--;
+
+    q = limb_array{};
+    r = limb_array{};
+
+    if (n == 1) {
+        limb remainder = 0;
+
+        for (std::size_t i = limb_count; i-- > 0;) {
+            dlimb current = static_cast<dlimb>(remainder) << 64 | u[i];
+            q[i] = static_cast<limb>(current / v[0]);
+            remainder = static_cast<limb>(current % v[0]);
+        }
+
+        r[0] = remainder;
+        return;
+    }
+
+    // Knuth's algorithm D needs two divisor limbs, which a single-limb type never has
+    if constexpr (limb_count > 1) {
+        std::size_t m = limb_count;
+        while (m && !u[m - 1]) m--;
+        if (m < n) {
+            r = u;
+            return;
+        }
+
+        // Knuth's algorithm D on copies normalized so that the divisor has its top bit set
+        int shift = __builtin_clzll(v[n - 1]);
+        limb un[limb_count + 1] = {}, vn[limb_count] = {};
+
+        for (std::size_t i = n; i-- > 0;) vn[i] = v[i] << shift | (shift && i ? v[i - 1] >> (64 - shift) : 0);
+
+        un[m] = (shift ? u[m - 1] >> (64 - shift) : 0);
+        for (std::size_t i = m; i-- > 0;) un[i] = u[i] << shift | (shift && i ? u[i - 1] >> (64 - shift) : 0);
+
+        for (std::size_t j = m - n + 1; j-- > 0;) {
+            dlimb top = static_cast<dlimb>(un[j + n]) << 64 | un[j + n - 1];
+            dlimb qhat = top / vn[n - 1], rhat = top % vn[n - 1];
+
+            while (qhat >> 64 || qhat * vn[n - 2] > (rhat << 64 | un[j + n - 2])) {
+                qhat--;
+                rhat += vn[n - 1];
+                if (rhat >> 64) break;
+            }
+
+            // un[j..j+n] -= qhat vn
+            limb borrow = 0, carry = 0;
+
+            for (std::size_t i = 0; i < n; i++) {
+                dlimb product = qhat * vn[i] + carry;
+                carry = static_cast<limb>(product >> 64);
+
+                limb low = static_cast<limb>(product);
+                limb difference = un[i + j] - low - borrow;
+                borrow = (un[i + j] < low || (un[i + j] == low && borrow)) ? 1 : 0;
+                un[i + j] = difference;
+            }
+
+            limb difference = un[j + n] - carry - borrow;
+            bool negative = (un[j + n] < carry || (un[j + n] == carry && borrow));
+            un[j + n] = difference;
+
+            if (negative) {
+                // qhat was one too large, add the divisor back
+                qhat--;
+                limb add_carry = 0;
+
+                for (std::size_t i = 0; i < n; i++) {
+                    dlimb sum = static_cast<dlimb>(un[i + j]) + vn[i] + add_carry;
+                    un[i + j] = static_cast<limb>(sum);
+                    add_carry = static_cast<limb>(sum >> 64);
+                }
+
+                un[j + n] += add_carry;
+            }
+
+            q[j] = static_cast<limb>(qhat);
+        }
+
+        for (std::size_t i = 0; i < n; i++) r[i] = un[i] >> shift | (shift ? un[i + 1] << (64 - shift) : 0);
+    }
+}
+
+//! In-class methods
+
+template<std::size_t Bits, bool Signed>
+std::string fixed_integer<Bits, Signed>::to_string() const {
+    constexpr limb chunk = 10000000000000000000ull; // 10^19
+
+    fixed_integer<Bits, false> rest(abs());
+    std::string digits;
+
+    do {
+        std::pair<fixed_integer<Bits, false>, fixed_integer<Bits, false>> parts = fixed_integer<Bits, false>::divmod(rest, chunk);
+        std::string part = std::to_string(static_cast<limb>(parts.second));
+
+        rest = parts.first;
+        if (rest) part.insert(0, 19 - part.size(), '0');
+
+        digits.insert(0, part);
+    } while (rest);
+
+    if (negative()) digits.insert(0, 1, '-');
+    return digits;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr bool fixed_integer<Bits, Signed>::negative() const {
+    return Signed && (limbs[limb_count - 1] >> 63);
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> fixed_integer<Bits, Signed>::abs() const {
+    return negative() ? -*this : *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr typename fixed_integer<Bits, Signed>::limb_array& fixed_integer<Bits, Signed>::_limbs() {
+    return limbs;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr const typename fixed_integer<Bits, Signed>::limb_array& fixed_integer<Bits, Signed>::_limbs() const {
+    return limbs;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>::operator bool() const {
+    limb any = 0;
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) any |= limbs[i];
+
+    return any;
+}
+
+template<std::size_t Bits, bool Signed>
+template<typename I, typename>
+constexpr fixed_integer<Bits, Signed>::operator I() const {
+    return static_cast<I>(limbs[0]);
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> fixed_integer<Bits, Signed>::operator-() const {
+    fixed_integer result = ~*this;
+    return ++result;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> fixed_integer<Bits, Signed>::operator+() const {
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> fixed_integer<Bits, Signed>::operator~() const {
+    fixed_integer result;
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) result.limbs[i] = ~limbs[i];
+
+    return result;
+}
+
+//! In-class arithmetic operators
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator+=(const fixed_integer& other) {
+    limb carry = 0;
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) {
+        limb sum = limbs[i] + carry;
+        carry = (sum < carry);
+
+        limbs[i] = sum + other.limbs[i];
+        carry += (limbs[i] < sum);
+    }
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator-=(const fixed_integer& other) {
+    limb borrow = 0;
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) {
+        limb difference = limbs[i] - other.limbs[i];
+        limb next = (limbs[i] < other.limbs[i]);
+
+        limbs[i] = difference - borrow;
+        borrow = next + (difference < borrow);
+    }
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator*=(const fixed_integer& other) {
+    // Schoolbook, only the limbs below 2^Bits; the same bits serve both signednesses
+    limb_array product{};
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) {
+        limb carry = 0;
+
+        #pragma GCC unroll 16
+        for (std::size_t j = 0; i + j < limb_count; j++) {
+            dlimb current = static_cast<dlimb>(limbs[i]) * other.limbs[j] + product[i + j] + carry;
+            product[i + j] = static_cast<limb>(current);
+            carry = static_cast<limb>(current >> 64);
+        }
+    }
+
+    limbs = product;
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator/=(const fixed_integer& other) {
+    *this = divmod(*this, other).first;
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator%=(const fixed_integer& other) {
+    *this = divmod(*this, other).second;
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator&=(const fixed_integer& other) {
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) limbs[i] &= other.limbs[i];
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator|=(const fixed_integer& other) {
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) limbs[i] |= other.limbs[i];
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator^=(const fixed_integer& other) {
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) limbs[i] ^= other.limbs[i];
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator<<=(std::size_t shift) {
+    std::size_t skip = (shift < Bits ? shift / 64 : limb_count);
+    int bits = shift % 64;
+
+    #pragma GCC unroll 16
+    for (std::size_t k = 0; k < limb_count; k++) {
+        std::size_t i = limb_count - 1 - k;
+        limb high = (i >= skip ? limbs[i - skip] : 0);
+        limb low = (i > skip ? limbs[i - skip - 1] : 0);
+
+        limbs[i] = (bits ? high << bits | low >> (64 - bits) : high);
+    }
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator>>=(std::size_t shift) {
+    limb extension = (negative() ? ~limb(0) : 0);
+    std::size_t skip = (shift < Bits ? shift / 64 : limb_count);
+    int bits = shift % 64;
+
+    #pragma GCC unroll 16
+    for (std::size_t i = 0; i < limb_count; i++) {
+        limb low = (i + skip < limb_count ? limbs[i + skip] : extension);
+        limb high = (i + skip + 1 < limb_count ? limbs[i + skip + 1] : extension);
+
+        limbs[i] = (bits ? low >> bits | high << (64 - bits) : low);
+    }
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator++() {
+    for (std::size_t i = 0; i < limb_count && !++limbs[i]; i++) {}
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> fixed_integer<Bits, Signed>::operator++(int) {
+    fixed_integer result = *this;
+    ++*this;
+    return result;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed>& fixed_integer<Bits, Signed>::operator--() {
+    for (std::size_t i = 0; i < limb_count && !limbs[i]--; i++) {}
+
+    return *this;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> fixed_integer<Bits, Signed>::operator--(int) {
+    fixed_integer result = *this;
+    --*this;
+    return result;
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr std::pair<fixed_integer<Bits, Signed>, fixed_integer<Bits, Signed>>
+fixed_integer<Bits, Signed>::divmod(const fixed_integer& self, const fixed_integer& other) {
+    if (!other) throw std::runtime_error("Division by zero");
+
+    fixed_integer u = self.abs(), v = other.abs();
+    fixed_integer quotient, remainder;
+
+    divide(u.limbs, v.limbs, quotient.limbs, remainder.limbs);
+
+    if (self.negative() != other.negative()) quotient = -quotient;
+    if (self.negative()) remainder = -remainder;
+
+    return {quotient, remainder};
+}
+
+template<std::size_t Bits, bool Signed>
+constexpr int fixed_integer<Bits, Signed>::compare(const fixed_integer& self, const fixed_integer& other) {
+    if (self.negative() != other.negative()) return self.negative() ? -1 : 1;
+
+    // Same sign: two's complement orders like the unsigned bits
+    for (std::size_t i = limb_count; i-- > 0;) {
+        if (self.limbs[i] != other.limbs[i]) return self.limbs[i] < other.limbs[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+//! Out-of-class functions
+
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> gcd(fixed_integer<Bits, Signed> self, fixed_integer<Bits, Signed> other) {
+    // Magnitudes as unsigned, so that the absolute value of the smallest signed one fits
+    using magnitude = fixed_integer<Bits, false>;
+
+    magnitude x(self.abs()), y(other.abs());
+
+    if (!x) return fixed_integer<Bits, Signed>(y);
+    if (!y) return fixed_integer<Bits, Signed>(x);
+
+    // Stein's algorithm: strip the common twos, then subtract odd from odd
+    auto trailing_zeros = [](const magnitude& value) {
+        std::size_t i = 0;
+        while (!value._limbs()[i]) i++;
+        return i * 64 + __builtin_ctzll(value._limbs()[i]);
+    };
+
+    std::size_t x_zeros = trailing_zeros(x), y_zeros = trailing_zeros(y);
+    std::size_t common = (x_zeros < y_zeros ? x_zeros : y_zeros);
+
+    x >>= x_zeros;
+    y >>= y_zeros;
+
+    while (true) {
+        if (x < y) {
+            magnitude smaller = x;
+            x = y;
+            y = smaller;
+        }
+
+        x -= y;
+        if (!x) break;
+
+        x >>= trailing_zeros(x);
+    }
+
+    return fixed_integer<Bits, Signed>(y <<= common);
+}
+
+template<std::size_t Bits, bool Signed>
+std::ostream& operator<<(std::ostream& stream, const fixed_integer<Bits, Signed>& value) {
+    stream << value.to_string();
+    return stream;
+}
+
+template<std::size_t Bits, bool Signed>
+std::istream& operator>>(std::istream& stream, fixed_integer<Bits, Signed>& value) {
+    std::string s;
+    stream >> s;
+
+    if (!stream) return stream;
+
+    try {
+        value = fixed_integer<Bits, Signed>(s);
+    }
+    catch (const std::invalid_argument&) {
+        stream.setstate(std::ios::failbit);
+    }
+
+    return stream;
+}
@@ -0,0 +1,135 @@
+#ifndef FIXED_INT_H
+#define FIXED_INT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+//! Integers of exactly Bits bits (a multiple of 64) in a std::array of limbs on the stack,
+//! for moduli and intermediates whose size is known in advance. Arithmetic wraps modulo
+//! 2^Bits like the built-in unsigned types; the signed flavour reads the same bits as two's
+//! complement. Everything is constexpr, and every loop has a compile-time bound, so for the
+//! usual 128 to 512 bits the compiler unrolls them completely.
+//!
+//! Built-in integers convert implicitly, so fixed_uint<256> works as the T of fraction and
+//! polynomial and as the vt of fast_power_mod. Division by zero throws std::runtime_error
+template<std::size_t Bits, bool Signed>
+class fixed_integer {
+    static_assert(Bits > 0 && Bits % 64 == 0, "fixed_integer: Bits must be a positive multiple of 64");
+public:
+    using limb = std::uint64_t;
+    using dlimb = unsigned __int128;
+
+    static constexpr std::size_t limb_count = Bits / 64;
+    using limb_array = std::array<limb, limb_count>;
+private:
+    limb_array limbs; // little endian
+
+    //! q = u / v and r = u mod v for magnitudes, v != 0
+    static constexpr void divide(const limb_array& u, const limb_array& v, limb_array& q, limb_array& r);
+public:
+    //! Rule of five
+    constexpr fixed_integer();
+
+    //! Sign-extends negative values, like a conversion between built-in integers
+    template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    constexpr fixed_integer(I value);
+
+    //! Truncates or extends (by sign, if other is signed) to Bits bits
+    template<std::size_t OtherBits, bool OtherSigned>
+    explicit constexpr fixed_integer(const fixed_integer<OtherBits, OtherSigned>& other);
+
+    //! Decimal with an optional sign, throws std::invalid_argument otherwise
+    explicit fixed_integer(const std::string& value);
+
+    //! In-class methods
+
+    std::string to_string() const;
+
+    constexpr bool negative() const;
+    constexpr fixed_integer abs() const;
+
+    constexpr limb_array& _limbs();
+    constexpr const limb_array& _limbs() const;
+
+    explicit constexpr operator bool() const;
+
+    //! The low bits, like a conversion between built-in integers
+    template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    explicit constexpr operator I() const;
+
+    constexpr fixed_integer operator-() const;
+    constexpr fixed_integer operator+() const;
+    constexpr fixed_integer operator~() const;
+
+    //! In-class arithmetic operators
+
+    constexpr fixed_integer& operator+=(const fixed_integer& other);
+    constexpr fixed_integer& operator-=(const fixed_integer& other);
+    constexpr fixed_integer& operator*=(const fixed_integer& other);
+    constexpr fixed_integer& operator/=(const fixed_integer& other);
+    constexpr fixed_integer& operator%=(const fixed_integer& other);
+
+    constexpr fixed_integer& operator&=(const fixed_integer& other);
+    constexpr fixed_integer& operator|=(const fixed_integer& other);
+    constexpr fixed_integer& operator^=(const fixed_integer& other);
+
+    //! Shifts by Bits or more give 0 (or -1 for negative signed values shifted right)
+    constexpr fixed_integer& operator<<=(std::size_t shift);
+    constexpr fixed_integer& operator>>=(std::size_t shift);
+
+    constexpr fixed_integer& operator++();
+    constexpr fixed_integer operator++(int);
+
+    constexpr fixed_integer& operator--();
+    constexpr fixed_integer operator--(int);
+
+    //! Quotient rounded toward zero and remainder with the sign of self, like the built-in integers
+    static constexpr std::pair<fixed_integer, fixed_integer> divmod(const fixed_integer& self, const fixed_integer& other);
+
+    static constexpr int compare(const fixed_integer& self, const fixed_integer& other);
+
+    //! Out-of-class operators, as friends so that built-in integers convert on either side
+
+    friend constexpr fixed_integer operator+(fixed_integer self, const fixed_integer& other) { return self += other; }
+    friend constexpr fixed_integer operator-(fixed_integer self, const fixed_integer& other) { return self -= other; }
+    friend constexpr fixed_integer operator*(fixed_integer self, const fixed_integer& other) { return self *= other; }
+    friend constexpr fixed_integer operator/(const fixed_integer& self, const fixed_integer& other) { return divmod(self, other).first; }
+    friend constexpr fixed_integer operator%(const fixed_integer& self, const fixed_integer& other) { return divmod(self, other).second; }
+
+    friend constexpr fixed_integer operator&(fixed_integer self, const fixed_integer& other) { return self &= other; }
+    friend constexpr fixed_integer operator|(fixed_integer self, const fixed_integer& other) { return self |= other; }
+    friend constexpr fixed_integer operator^(fixed_integer self, const fixed_integer& other) { return self ^= other; }
+
+    friend constexpr fixed_integer operator<<(fixed_integer self, std::size_t shift) { return self <<= shift; }
+    friend constexpr fixed_integer operator>>(fixed_integer self, std::size_t shift) { return self >>= shift; }
+
+    friend constexpr bool operator<(const fixed_integer& self, const fixed_integer& other) { return compare(self, other) < 0; }
+    friend constexpr bool operator>(const fixed_integer& self, const fixed_integer& other) { return compare(self, other) > 0; }
+    friend constexpr bool operator<=(const fixed_integer& self, const fixed_integer& other) { return compare(self, other) <= 0; }
+    friend constexpr bool operator>=(const fixed_integer& self, const fixed_integer& other) { return compare(self, other) >= 0; }
+    friend constexpr bool operator==(const fixed_integer& self, const fixed_integer& other) { return compare(self, other) == 0; }
+    friend constexpr bool operator!=(const fixed_integer& self, const fixed_integer& other) { return compare(self, other) != 0; }
+};
+
+template<std::size_t Bits>
+using fixed_uint = fixed_integer<Bits, false>;
+
+template<std::size_t Bits>
+using fixed_int = fixed_integer<Bits, true>;
+
+//! Nonnegative, gcd(0, 0) = 0. Binary algorithm, found by fraction through ADL
+template<std::size_t Bits, bool Signed>
+constexpr fixed_integer<Bits, Signed> gcd(fixed_integer<Bits, Signed> self, fixed_integer<Bits, Signed> other);
+
+template<std::size_t Bits, bool Signed>
+std::ostream& operator<<(std::ostream& stream, const fixed_integer<Bits, Signed>& value);
+
+template<std::size_t Bits, bool Signed>
+std::istream& operator>>(std::istream& stream, fixed_integer<Bits, Signed>& value);
+
+#endif // FIXED_INT_H
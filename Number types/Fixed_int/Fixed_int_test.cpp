@@ -0,0 +1,9 @@
+#include <iostream>
+#include "Fixed_int.h"
+#include "Fixed_int.cpp"
+
+int main() {
+    fixed_int<256> a, b;
+    std::cin >> a >> b;
+    std::cout << a + b << " " << a - b << " " << a * b << " " << a / b << " " << a % b << " " << (a < b) << std::endl;
+}
@@ -10,7 +10,8 @@ fraction<T>::fraction(T scalar): numerator(scalar), denominator(T(1)) {}
 
 template <class T>
 fraction<T>::fraction(T _numerator, T _denominator): numerator(_numerator), denominator(_denominator) {
-    T tmp = std::gcd(std::abs(numerator), std::abs(denominator));
+    using std::gcd;
+    T tmp = gcd(numerator, denominator);
     if (tmp == 0) return;
 
     numerator /= tmp;
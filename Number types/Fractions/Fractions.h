@@ -7,6 +7,8 @@
 #include <fstream>
 #include <string>
 
+class binary_reader;
+
 template<class T>
 class fraction {
 private:
@@ -50,6 +52,10 @@ public:
 
     T num() const;
     T denom() const;
+
+    //! Binary format, see Fractions_binary.h. Stored fractions are already reduced, so reading skips the gcd
+    template<class U>
+    friend void read_binary(binary_reader& reader, fraction<U>& value);
 };
 
 #endif // FRACTIONS_H
\ No newline at end of file
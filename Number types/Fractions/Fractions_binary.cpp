@@ -0,0 +1,23 @@
+#include "Fractions_binary.h"
+
+#include <stdexcept>
+
+template<class T>
+void write_binary(binary_writer& writer, const fraction<T>& value) {
+    write_binary(writer, value.num());
+    write_binary(writer, value.denom());
+}
+
+template<class T>
+void read_binary(binary_reader& reader, fraction<T>& value) {
+    read_binary(reader, value.numerator);
+    read_binary(reader, value.denominator);
+
+    if (!(value.denominator > 0)) throw std::runtime_error("binary: malformed fraction");
+}
+
+template<class T>
+void skip_binary(binary_reader& reader, binary_tag<fraction<T>>) {
+    skip_binary(reader, binary_tag<T>());
+    skip_binary(reader, binary_tag<T>());
+}
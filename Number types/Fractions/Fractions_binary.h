@@ -0,0 +1,20 @@
+#pragma once
+#ifndef FRACTIONS_BINARY_H
+#define FRACTIONS_BINARY_H
+
+#include "Fractions.h"
+#include "../Big_int/Binary.h"
+
+//! Binary format of fraction<T>, see Binary.h: the numerator, then the positive denominator,
+//! both as records of T. Stored fractions are already reduced, so reading skips the gcd
+
+template<class T>
+void write_binary(binary_writer& writer, const fraction<T>& value);
+
+template<class T>
+void read_binary(binary_reader& reader, fraction<T>& value);
+
+template<class T>
+void skip_binary(binary_reader& reader, binary_tag<fraction<T>>);
+
+#endif // FRACTIONS_BINARY_H
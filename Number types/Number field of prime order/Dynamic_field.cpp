@@ -0,0 +1,207 @@
+#include "Dynamic_field.h"
+
+#include <vector>
+
+//! The context of the innermost modulus_scope of the thread, one for every translation unit
+//! that includes this file
+inline const modulus_context*& installed_modulus() {
+    thread_local const modulus_context* installed = nullptr;
+    return installed;
+}
+
+//! modulus_context
+
+inline modulus_context::modulus_context(word modulus): p(modulus), inverse_p(modulus), r2_mod_p(0) {
+    if (modulus < 3 || modulus % 2 == 0) throw std::invalid_argument("modulus_context: the modulus must be odd and at least 3");
+
+    // Newton's iteration for p^-1 mod 2^64, each step doubles the correct low bits
+    for (int i = 0; i < 5; i++) inverse_p *= 2 - p * inverse_p;
+
+    word r_mod_p = (0 - p) % p;
+    r2_mod_p = static_cast<word>(dword(r_mod_p) * r_mod_p % p);
+}
+
+inline modulus_context::word modulus_context::inverse(word a) const {
+    // The Bezout coefficients of a alternate in sign, so their magnitudes are tracked in words
+    // (they stay below p) together with the parity of the step count
+    word x = 1, y = 0, b = p;
+    bool negative = false;
+
+    a = from_form(a);
+
+    while (b) {
+        word quotient = a / b;
+
+        word remainder = a - quotient * b;
+        a = b;
+        b = remainder;
+
+        word coefficient = x + quotient * y;
+        x = y;
+        y = coefficient;
+
+        negative = !negative;
+    }
+
+    if (a != 1) throw std::runtime_error("Division by zero");
+    if (negative) x = p - x;
+
+    return to_form(x);
+}
+
+//! modulus_scope
+
+inline modulus_scope::modulus_scope(const modulus_context& context): previous(installed_modulus()) {
+    installed_modulus() = &context;
+}
+
+inline modulus_scope::~modulus_scope() {
+    installed_modulus() = previous;
+}
+
+inline const modulus_context* current_modulus() {
+    return installed_modulus();
+}
+
+//! Rule of five
+
+inline dynamic_field::dynamic_field(): modulus(installed_modulus()), number(0) {}
+
+//! Bool operators
+
+inline bool dynamic_field::operator<(const dynamic_field& other) const {
+    check(other);
+    return get_number() < other.get_number();
+}
+
+inline bool dynamic_field::operator>(const dynamic_field& other) const {
+    return other < *this;
+}
+
+inline bool dynamic_field::operator<=(const dynamic_field& other) const {
+    return !(*this > other);
+}
+
+inline bool dynamic_field::operator>=(const dynamic_field& other) const {
+    return !(*this < other);
+}
+
+inline bool dynamic_field::operator==(const dynamic_field& other) const {
+    // The storage form is a bijection, and zero is zero in every form
+    check(other);
+    return number == other.number;
+}
+
+inline bool dynamic_field::operator!=(const dynamic_field& other) const {
+    return !(other == *this);
+}
+
+//! In-class arithmetic operators
+
+inline dynamic_field& dynamic_field::operator/=(const dynamic_field& other) {
+    *this *= other.inverse();
+    return *this;
+}
+
+inline dynamic_field& dynamic_field::operator^=(std::uint64_t power) {
+    *this = (*this) ^ power;
+    return *this;
+}
+
+inline dynamic_field dynamic_field::operator+() const {
+    return *this;
+}
+
+inline dynamic_field dynamic_field::operator-() const {
+    dynamic_field result = *this;
+    if (modulus) result.number = modulus->subtract(0, number);
+
+    return result;
+}
+
+//! Methods
+
+inline dynamic_field dynamic_field::inverse() const {
+    if (!modulus) throw std::runtime_error("Division by zero");
+
+    dynamic_field result = *this;
+    result.number = modulus->inverse(number);
+    return result;
+}
+
+inline dynamic_field::word dynamic_field::get_number() const {
+    return modulus ? modulus->from_form(number) : 0;
+}
+
+inline const modulus_context* dynamic_field::context() const {
+    return modulus;
+}
+
+//! Out-of-class functions
+
+inline dynamic_field operator/(const dynamic_field& self, const dynamic_field& other) {
+    dynamic_field result = self;
+    result /= other;
+    return result;
+}
+
+inline dynamic_field operator^(dynamic_field self, std::uint64_t power) {
+    if (!self.context()) {
+        // A context-free zero: 0^k = 0, but 0^0 = 1 needs a modulus
+        if (power) return self;
+        throw std::runtime_error("dynamic_field: no modulus for 0^0");
+    }
+
+    dynamic_field result(*self.context(), 1);
+
+    while (power > 0) {
+        if (power & 1) result *= self;
+        power >>= 1;
+        self *= self;
+    }
+
+    return result;
+}
+
+inline void batch_inverse(dynamic_field* first, dynamic_field* last) {
+    std::size_t n = last - first;
+    if (!n) return;
+
+    // prefix[i] = first[0] ... first[i], so one inversion of the whole product serves every element
+    std::vector<dynamic_field> prefix(n);
+    prefix[0] = first[0];
+
+    for (std::size_t i = 1; i < n; i++) prefix[i] = prefix[i - 1] * first[i];
+
+    dynamic_field inverse = prefix[n - 1].inverse();
+
+    for (std::size_t i = n - 1; i > 0; i--) {
+        dynamic_field value = first[i];
+
+        first[i] = inverse * prefix[i - 1];
+        inverse *= value;
+    }
+
+    first[0] = inverse;
+}
+
+inline std::ostream& operator<<(std::ostream& out, const dynamic_field& number) {
+    out << number.get_number();
+    return out;
+}
+
+inline std::istream& operator>>(std::istream& in, dynamic_field& number) {
+    // Unsigned unless there is a minus, so that residues of 64-bit moduli can be read
+    in >> std::ws;
+
+    if (in.peek() == '-') {
+        long long n;
+        if (in >> n) number = dynamic_field(n);
+    }
+    else {
+        unsigned long long n;
+        if (in >> n) number = dynamic_field(n);
+    }
+
+    return in;
+}
@@ -0,0 +1,264 @@
+#ifndef DYNAMIC_FIELD_H
+#define DYNAMIC_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+//! Residues modulo a p known only at run time, the counterpart of number_field<p>.
+//!
+//! A modulus_context precomputes the Montgomery constants of an odd p once (R = 2^64), and
+//! every dynamic_field value points to its context. Even moduli are left to number_field<p>,
+//! a runtime check for them would slow down every multiplication.
+//! Values made from plain integers, such as the T(0) and T(1) inside polynomial<T>, take
+//! the context installed by the innermost modulus_scope of the thread:
+//!
+//!     modulus_context p(1000000007);
+//!     modulus_scope scope(p);
+//!     polynomial<dynamic_field> f(std::vector<dynamic_field>{1, 2, 3});
+//!
+//! Both operands of an operation must share the modulus, std::invalid_argument is thrown
+//! otherwise. A default-constructed zero made outside of any scope adopts the modulus of the
+//! other operand (two such zeros cannot meet). Contexts must outlive their values.
+//! The arithmetic is defined inline here, since an out-of-line call would cost more than the
+//! multiplication itself. The rest, in Dynamic_field.cpp, is inline as well, so users include
+//! that file like the .cpp of a template, from any number of translation units
+class modulus_context {
+public:
+    using word = std::uint64_t;
+private:
+    using dword = unsigned __int128;
+
+    word p;
+    word inverse_p;  // p^-1 mod 2^64
+    word r2_mod_p;   // 2^128 mod p
+
+    //! t 2^-64 mod p for t < p 2^64
+    word reduce(dword t) const;
+public:
+    //! Rule of five
+    //! Throws std::invalid_argument unless modulus is odd and at least 3
+    explicit modulus_context(word modulus);
+
+    //! Methods
+
+    word modulus() const;
+
+    //! Residues are stored in Montgomery form, x 2^64 mod p
+    word to_form(word x) const;
+    word from_form(word x) const;
+
+    word add(word a, word b) const;
+    word subtract(word a, word b) const;
+    word multiply(word a, word b) const;
+
+    //! Throws std::runtime_error("Division by zero") if a has no inverse
+    word inverse(word a) const;
+};
+
+//! Installs context for the values made from integers on the current thread, until the scope ends
+class modulus_scope {
+private:
+    const modulus_context* previous;
+public:
+    //! Rule of five
+    explicit modulus_scope(const modulus_context& context);
+    modulus_scope(const modulus_scope& other) = delete;
+    ~modulus_scope();
+
+    modulus_scope& operator=(const modulus_scope& other) = delete;
+};
+
+//! The context installed by the innermost modulus_scope, nullptr outside of any
+const modulus_context* current_modulus();
+
+class dynamic_field {
+public:
+    using word = modulus_context::word;
+private:
+    const modulus_context* modulus;
+    word number; // in the storage form of the context
+
+    //! Throws std::invalid_argument unless other has the same modulus, or one of them is a context-free zero
+    void check(const dynamic_field& other) const;
+
+    //! The context shared with other, which may stand in for a default-constructed zero
+    const modulus_context& shared(const dynamic_field& other) const;
+
+    //! Reduced into [0, p) like a mathematical residue
+    template<typename I>
+    static word residue(const modulus_context& context, I value);
+public:
+    //! Rule of five
+
+    //! Zero in the current context, or a context-free zero outside of any scope
+    dynamic_field();
+
+    //! In the current context, throws std::runtime_error outside of any modulus_scope
+    template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    dynamic_field(I value);
+
+    template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    dynamic_field(const modulus_context& context, I value);
+
+    //! Bool operators, the order is the one of the residues in [0, p)
+
+    bool operator<(const dynamic_field& other) const;
+    bool operator>(const dynamic_field& other) const;
+    bool operator<=(const dynamic_field& other) const;
+    bool operator>=(const dynamic_field& other) const;
+    bool operator==(const dynamic_field& other) const;
+    bool operator!=(const dynamic_field& other) const;
+
+    //! Arithmetic operators
+
+    dynamic_field& operator+=(const dynamic_field& other);
+    dynamic_field& operator*=(const dynamic_field& other);
+    dynamic_field& operator-=(const dynamic_field& other);
+    dynamic_field& operator/=(const dynamic_field& other);
+    dynamic_field& operator^=(std::uint64_t power);
+
+    dynamic_field operator+() const;
+    dynamic_field operator-() const;
+
+    //! Methods
+
+    //! By the extended Euclidean algorithm, throws std::runtime_error if there is none
+    dynamic_field inverse() const;
+
+    //! The residue in [0, p)
+    word get_number() const;
+
+    //! nullptr for a context-free zero
+    const modulus_context* context() const;
+};
+
+//! Out-of-class operators
+
+dynamic_field operator+(const dynamic_field& self, const dynamic_field& other);
+dynamic_field operator-(const dynamic_field& self, const dynamic_field& other);
+dynamic_field operator*(const dynamic_field& self, const dynamic_field& other);
+dynamic_field operator/(const dynamic_field& self, const dynamic_field& other);
+dynamic_field operator^(dynamic_field self, std::uint64_t power);
+
+//! Like the number_field one: a single inversion and 3 (n - 1) multiplications, throws
+//! std::runtime_error, leaving the range untouched, if any element has no inverse
+void batch_inverse(dynamic_field* first, dynamic_field* last);
+
+std::ostream& operator<<(std::ostream& out, const dynamic_field& number);
+
+//! Reads an integer into the current context
+std::istream& operator>>(std::istream& in, dynamic_field& number);
+
+//! Inline definitions
+
+inline modulus_context::word modulus_context::reduce(dword t) const {
+    word m = static_cast<word>(t) * inverse_p;
+    word high = static_cast<word>(t >> 64);
+    word subtrahend = static_cast<word>(dword(m) * p >> 64);
+
+    return high - subtrahend + (p & -static_cast<word>(high < subtrahend));
+}
+
+inline modulus_context::word modulus_context::modulus() const {
+    return p;
+}
+
+inline modulus_context::word modulus_context::to_form(word x) const {
+    return reduce(dword(x) * r2_mod_p);
+}
+
+inline modulus_context::word modulus_context::from_form(word x) const {
+    return reduce(x);
+}
+
+inline modulus_context::word modulus_context::add(word a, word b) const {
+    word complement = p - b;
+    return a - complement + (p & -static_cast<word>(a < complement));
+}
+
+inline modulus_context::word modulus_context::subtract(word a, word b) const {
+    return a - b + (p & -static_cast<word>(a < b));
+}
+
+inline modulus_context::word modulus_context::multiply(word a, word b) const {
+    return reduce(dword(a) * b);
+}
+
+inline void dynamic_field::check(const dynamic_field& other) const {
+    // Distinct contexts of the same modulus have the same storage form
+    if (modulus != other.modulus && modulus && other.modulus && modulus->modulus() != other.modulus->modulus()) {
+        throw std::invalid_argument("dynamic_field: the operands have different moduli");
+    }
+}
+
+inline const modulus_context& dynamic_field::shared(const dynamic_field& other) const {
+    check(other);
+    return *(modulus ? modulus : other.modulus);
+}
+
+template<typename I>
+dynamic_field::word dynamic_field::residue(const modulus_context& context, I value) {
+    std::make_unsigned_t<I> magnitude = static_cast<std::make_unsigned_t<I>>(value);
+    bool negative = false;
+
+    if constexpr (std::is_signed_v<I>) {
+        negative = (value < 0);
+        if (negative) magnitude = static_cast<std::make_unsigned_t<I>>(0 - magnitude);
+    }
+
+    word result = static_cast<word>(magnitude % context.modulus());
+    if (negative && result) result = context.modulus() - result;
+
+    return context.to_form(result);
+}
+
+template<typename I, typename>
+dynamic_field::dynamic_field(I value): modulus(current_modulus()) {
+    if (!modulus) throw std::runtime_error("dynamic_field: no modulus_scope is active");
+
+    number = residue(*modulus, value);
+}
+
+template<typename I, typename>
+dynamic_field::dynamic_field(const modulus_context& context, I value): modulus(&context), number(residue(context, value)) {}
+
+inline dynamic_field& dynamic_field::operator+=(const dynamic_field& other) {
+    modulus = &shared(other);
+    number = modulus->add(number, other.number);
+    return *this;
+}
+
+inline dynamic_field& dynamic_field::operator-=(const dynamic_field& other) {
+    modulus = &shared(other);
+    number = modulus->subtract(number, other.number);
+    return *this;
+}
+
+inline dynamic_field& dynamic_field::operator*=(const dynamic_field& other) {
+    modulus = &shared(other);
+    number = modulus->multiply(number, other.number);
+    return *this;
+}
+
+inline dynamic_field operator+(const dynamic_field& self, const dynamic_field& other) {
+    dynamic_field result = self;
+    result += other;
+    return result;
+}
+
+inline dynamic_field operator-(const dynamic_field& self, const dynamic_field& other) {
+    dynamic_field result = self;
+    result -= other;
+    return result;
+}
+
+inline dynamic_field operator*(const dynamic_field& self, const dynamic_field& other) {
+    dynamic_field result = self;
+    result *= other;
+    return result;
+}
+
+#endif // DYNAMIC_FIELD_H
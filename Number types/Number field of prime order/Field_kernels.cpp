@@ -0,0 +1,365 @@
+#include "Field_kernels.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define FIELD_KERNELS_X86_64
+#endif
+
+namespace field_kernels {
+
+namespace {
+
+using dword = std::uint64_t;
+
+//! Scalar arithmetic, the same as in number_field<p>, for the portable kernels and the tails
+
+inline word add(word a, word b, word p) {
+    word complement = p - b;
+    return a - complement + (p & -static_cast<word>(a < complement));
+}
+
+inline word subtract(word a, word b, word p) {
+    return a - b + (p & -static_cast<word>(a < b));
+}
+
+inline word multiply(word a, word b, word p, word inverse_p) {
+    dword t = dword(a) * b;
+    word m = static_cast<word>(t) * inverse_p;
+    word high = static_cast<word>(t >> 32);
+    word subtrahend = static_cast<word>(dword(m) * p >> 32);
+
+    return high - subtrahend + (p & -static_cast<word>(high < subtrahend));
+}
+
+void add_n_portable(word* r, const word* a, const word* b, std::size_t n, word p) {
+    for (std::size_t i = 0; i < n; i++) r[i] = add(a[i], b[i], p);
+}
+
+void sub_n_portable(word* r, const word* a, const word* b, std::size_t n, word p) {
+    for (std::size_t i = 0; i < n; i++) r[i] = subtract(a[i], b[i], p);
+}
+
+void mul_n_portable(word* r, const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    for (std::size_t i = 0; i < n; i++) r[i] = multiply(a[i], b[i], p, inverse_p);
+}
+
+void fma_n_portable(word* r, const word* a, const word* b, const word* c, std::size_t n, word p, word inverse_p) {
+    for (std::size_t i = 0; i < n; i++) r[i] = add(multiply(a[i], b[i], p, inverse_p), c[i], p);
+}
+
+void scale_n_portable(word* r, const word* a, word c, std::size_t n, word p, word inverse_p) {
+    for (std::size_t i = 0; i < n; i++) r[i] = multiply(a[i], c, p, inverse_p);
+}
+
+word dot_product_portable(const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    word sum = 0;
+    for (std::size_t i = 0; i < n; i++) sum = add(sum, multiply(a[i], b[i], p, inverse_p), p);
+    return sum;
+}
+
+struct kernel_table {
+    const char* name;
+
+    void (*add_n)(word* r, const word* a, const word* b, std::size_t n, word p);
+    void (*sub_n)(word* r, const word* a, const word* b, std::size_t n, word p);
+    void (*mul_n)(word* r, const word* a, const word* b, std::size_t n, word p, word inverse_p);
+    void (*fma_n)(word* r, const word* a, const word* b, const word* c, std::size_t n, word p, word inverse_p);
+    void (*scale_n)(word* r, const word* a, word c, std::size_t n, word p, word inverse_p);
+    word (*dot_product)(const word* a, const word* b, std::size_t n, word p, word inverse_p);
+};
+
+const kernel_table portable_kernels = {
+    "portable", add_n_portable, sub_n_portable, mul_n_portable, fma_n_portable, scale_n_portable, dot_product_portable
+};
+
+#if defined(FIELD_KERNELS_X86_64)
+
+//! AVX2 kernels, 8 residues per vector. vpmuludq multiplies the even 32-bit lanes into
+//! 64-bit products, so a Montgomery product runs once on the even lanes and once on the
+//! odd ones shifted down, and the high halves are blended back together. There is no
+//! unsigned 32-bit compare, a borrow of a - b shows as max(a, b) != a
+
+__attribute__((target("avx2"))) inline __m256i subtract_avx2(__m256i a, __m256i b, __m256i p) {
+    __m256i no_borrow = _mm256_cmpeq_epi32(_mm256_max_epu32(a, b), a);
+    return _mm256_add_epi32(_mm256_sub_epi32(a, b), _mm256_andnot_si256(no_borrow, p));
+}
+
+__attribute__((target("avx2"))) inline __m256i add_avx2(__m256i a, __m256i b, __m256i p) {
+    return subtract_avx2(a, _mm256_sub_epi32(p, b), p);
+}
+
+__attribute__((target("avx2"))) inline __m256i multiply_avx2(__m256i a, __m256i b, __m256i p, __m256i inverse_p) {
+    __m256i even = _mm256_mul_epu32(a, b);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+    // m = t p^-1 mod 2^32 sits in the low half of each lane, which is all vpmuludq reads
+    __m256i even_mp = _mm256_mul_epu32(_mm256_mul_epu32(even, inverse_p), p);
+    __m256i odd_mp = _mm256_mul_epu32(_mm256_mul_epu32(odd, inverse_p), p);
+
+    __m256i high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+    __m256i subtrahend = _mm256_blend_epi32(_mm256_srli_epi64(even_mp, 32), odd_mp, 0xaa);
+
+    return subtract_avx2(high, subtrahend, p);
+}
+
+__attribute__((target("avx2"))) inline __m256i load_avx2(const word* a) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+}
+
+__attribute__((target("avx2"))) inline void store_avx2(word* r, __m256i x) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r), x);
+}
+
+__attribute__((target("avx2"))) void add_n_avx2(word* r, const word* a, const word* b, std::size_t n, word p) {
+    __m256i vp = _mm256_set1_epi32(static_cast<int>(p));
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) store_avx2(r + i, add_avx2(load_avx2(a + i), load_avx2(b + i), vp));
+
+    add_n_portable(r + i, a + i, b + i, n - i, p);
+}
+
+__attribute__((target("avx2"))) void sub_n_avx2(word* r, const word* a, const word* b, std::size_t n, word p) {
+    __m256i vp = _mm256_set1_epi32(static_cast<int>(p));
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) store_avx2(r + i, subtract_avx2(load_avx2(a + i), load_avx2(b + i), vp));
+
+    sub_n_portable(r + i, a + i, b + i, n - i, p);
+}
+
+__attribute__((target("avx2"))) void mul_n_avx2(word* r, const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    __m256i vp = _mm256_set1_epi32(static_cast<int>(p)), vinverse = _mm256_set1_epi32(static_cast<int>(inverse_p));
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) store_avx2(r + i, multiply_avx2(load_avx2(a + i), load_avx2(b + i), vp, vinverse));
+
+    mul_n_portable(r + i, a + i, b + i, n - i, p, inverse_p);
+}
+
+__attribute__((target("avx2"))) void fma_n_avx2(word* r, const word* a, const word* b, const word* c, std::size_t n, word p, word inverse_p) {
+    __m256i vp = _mm256_set1_epi32(static_cast<int>(p)), vinverse = _mm256_set1_epi32(static_cast<int>(inverse_p));
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i product = multiply_avx2(load_avx2(a + i), load_avx2(b + i), vp, vinverse);
+        store_avx2(r + i, add_avx2(product, load_avx2(c + i), vp));
+    }
+
+    fma_n_portable(r + i, a + i, b + i, c + i, n - i, p, inverse_p);
+}
+
+__attribute__((target("avx2"))) void scale_n_avx2(word* r, const word* a, word c, std::size_t n, word p, word inverse_p) {
+    __m256i vp = _mm256_set1_epi32(static_cast<int>(p)), vinverse = _mm256_set1_epi32(static_cast<int>(inverse_p));
+    __m256i vc = _mm256_set1_epi32(static_cast<int>(c));
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) store_avx2(r + i, multiply_avx2(load_avx2(a + i), vc, vp, vinverse));
+
+    scale_n_portable(r + i, a + i, c, n - i, p, inverse_p);
+}
+
+__attribute__((target("avx2"))) word dot_product_avx2(const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    __m256i vp = _mm256_set1_epi32(static_cast<int>(p)), vinverse = _mm256_set1_epi32(static_cast<int>(inverse_p));
+    __m256i sum = _mm256_setzero_si256();
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) sum = add_avx2(sum, multiply_avx2(load_avx2(a + i), load_avx2(b + i), vp, vinverse), vp);
+
+    word lanes[8];
+    store_avx2(lanes, sum);
+
+    word result = dot_product_portable(a + i, b + i, n - i, p, inverse_p);
+    for (word lane : lanes) result = add(result, lane, p);
+
+    return result;
+}
+
+//! AVX-512 kernels, 16 residues per vector, the same scheme with mask registers for the
+//! blends and a native unsigned compare for the borrows
+
+// GCC 12 flags the undefined pass-through operand inside the AVX-512 intrinsics
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f"))) inline __m512i subtract_avx512(__m512i a, __m512i b, __m512i p) {
+    __m512i diff = _mm512_sub_epi32(a, b);
+    return _mm512_mask_add_epi32(diff, _mm512_cmplt_epu32_mask(a, b), diff, p);
+}
+
+__attribute__((target("avx512f"))) inline __m512i add_avx512(__m512i a, __m512i b, __m512i p) {
+    return subtract_avx512(a, _mm512_sub_epi32(p, b), p);
+}
+
+__attribute__((target("avx512f"))) inline __m512i multiply_avx512(__m512i a, __m512i b, __m512i p, __m512i inverse_p) {
+    __m512i even = _mm512_mul_epu32(a, b);
+    __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+
+    __m512i even_mp = _mm512_mul_epu32(_mm512_mul_epu32(even, inverse_p), p);
+    __m512i odd_mp = _mm512_mul_epu32(_mm512_mul_epu32(odd, inverse_p), p);
+
+    __m512i high = _mm512_mask_blend_epi32(0xaaaa, _mm512_srli_epi64(even, 32), odd);
+    __m512i subtrahend = _mm512_mask_blend_epi32(0xaaaa, _mm512_srli_epi64(even_mp, 32), odd_mp);
+
+    return subtract_avx512(high, subtrahend, p);
+}
+
+__attribute__((target("avx512f"))) void add_n_avx512(word* r, const word* a, const word* b, std::size_t n, word p) {
+    __m512i vp = _mm512_set1_epi32(static_cast<int>(p));
+    std::size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) _mm512_storeu_si512(r + i, add_avx512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i), vp));
+
+    add_n_portable(r + i, a + i, b + i, n - i, p);
+}
+
+__attribute__((target("avx512f"))) void sub_n_avx512(word* r, const word* a, const word* b, std::size_t n, word p) {
+    __m512i vp = _mm512_set1_epi32(static_cast<int>(p));
+    std::size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) _mm512_storeu_si512(r + i, subtract_avx512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i), vp));
+
+    sub_n_portable(r + i, a + i, b + i, n - i, p);
+}
+
+__attribute__((target("avx512f"))) void mul_n_avx512(word* r, const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    __m512i vp = _mm512_set1_epi32(static_cast<int>(p)), vinverse = _mm512_set1_epi32(static_cast<int>(inverse_p));
+    std::size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_si512(r + i, multiply_avx512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i), vp, vinverse));
+    }
+
+    mul_n_portable(r + i, a + i, b + i, n - i, p, inverse_p);
+}
+
+__attribute__((target("avx512f"))) void fma_n_avx512(word* r, const word* a, const word* b, const word* c, std::size_t n, word p, word inverse_p) {
+    __m512i vp = _mm512_set1_epi32(static_cast<int>(p)), vinverse = _mm512_set1_epi32(static_cast<int>(inverse_p));
+    std::size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m512i product = multiply_avx512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i), vp, vinverse);
+        _mm512_storeu_si512(r + i, add_avx512(product, _mm512_loadu_si512(c + i), vp));
+    }
+
+    fma_n_portable(r + i, a + i, b + i, c + i, n - i, p, inverse_p);
+}
+
+__attribute__((target("avx512f"))) void scale_n_avx512(word* r, const word* a, word c, std::size_t n, word p, word inverse_p) {
+    __m512i vp = _mm512_set1_epi32(static_cast<int>(p)), vinverse = _mm512_set1_epi32(static_cast<int>(inverse_p));
+    __m512i vc = _mm512_set1_epi32(static_cast<int>(c));
+    std::size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) _mm512_storeu_si512(r + i, multiply_avx512(_mm512_loadu_si512(a + i), vc, vp, vinverse));
+
+    scale_n_portable(r + i, a + i, c, n - i, p, inverse_p);
+}
+
+__attribute__((target("avx512f"))) word dot_product_avx512(const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    __m512i vp = _mm512_set1_epi32(static_cast<int>(p)), vinverse = _mm512_set1_epi32(static_cast<int>(inverse_p));
+    __m512i sum = _mm512_setzero_si512();
+    std::size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        sum = add_avx512(sum, multiply_avx512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i), vp, vinverse), vp);
+    }
+
+    word lanes[16];
+    _mm512_storeu_si512(lanes, sum);
+
+    word result = dot_product_portable(a + i, b + i, n - i, p, inverse_p);
+    for (word lane : lanes) result = add(result, lane, p);
+
+    return result;
+}
+
+#pragma GCC diagnostic pop
+
+const kernel_table avx2_kernels = {
+    "avx2", add_n_avx2, sub_n_avx2, mul_n_avx2, fma_n_avx2, scale_n_avx2, dot_product_avx2
+};
+
+const kernel_table avx512_kernels = {
+    "avx512", add_n_avx512, sub_n_avx512, mul_n_avx512, fma_n_avx512, scale_n_avx512, dot_product_avx512
+};
+
+#endif
+
+const kernel_table* detect_kernels() {
+#if defined(FIELD_KERNELS_X86_64)
+    // Unlike a bare cpuid, these also check that the OS saves the vector registers
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) return &avx512_kernels;
+    if (__builtin_cpu_supports("avx2")) return &avx2_kernels;
+#endif
+
+    return &portable_kernels;
+}
+
+//! The tables are constants, so a relaxed load is enough even on the first racing calls
+std::atomic<const kernel_table*> active_kernels{nullptr};
+
+const kernel_table& kernels() {
+    const kernel_table* table = active_kernels.load(std::memory_order_relaxed);
+
+    if (!table) {
+        table = detect_kernels();
+        active_kernels.store(table, std::memory_order_relaxed);
+    }
+
+    return *table;
+}
+
+} // namespace
+
+void add_n(word* r, const word* a, const word* b, std::size_t n, word p) {
+    kernels().add_n(r, a, b, n, p);
+}
+
+void sub_n(word* r, const word* a, const word* b, std::size_t n, word p) {
+    kernels().sub_n(r, a, b, n, p);
+}
+
+void mul_n(word* r, const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    kernels().mul_n(r, a, b, n, p, inverse_p);
+}
+
+void fma_n(word* r, const word* a, const word* b, const word* c, std::size_t n, word p, word inverse_p) {
+    kernels().fma_n(r, a, b, c, n, p, inverse_p);
+}
+
+void scale_n(word* r, const word* a, word c, std::size_t n, word p, word inverse_p) {
+    kernels().scale_n(r, a, c, n, p, inverse_p);
+}
+
+word dot_product(const word* a, const word* b, std::size_t n, word p, word inverse_p) {
+    return kernels().dot_product(a, b, n, p, inverse_p);
+}
+
+const char* kernel_name() {
+    return kernels().name;
+}
+
+bool select_kernels(const char* name) {
+    const kernel_table* table = nullptr;
+
+    if (!std::strcmp(name, portable_kernels.name)) table = &portable_kernels;
+
+#if defined(FIELD_KERNELS_X86_64)
+    __builtin_cpu_init();
+
+    if (!std::strcmp(name, avx2_kernels.name) && __builtin_cpu_supports("avx2")) table = &avx2_kernels;
+    if (!std::strcmp(name, avx512_kernels.name) && __builtin_cpu_supports("avx512f")) table = &avx512_kernels;
+#endif
+
+    if (!table) return false;
+
+    active_kernels.store(table, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace field_kernels
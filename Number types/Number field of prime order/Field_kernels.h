@@ -0,0 +1,44 @@
+#ifndef FIELD_KERNELS_H
+#define FIELD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+//! Element-wise arithmetic over arrays of residues modulo an odd p < 2^32, all in the
+//! Montgomery form x 2^32 mod p used by number_field<p>. inverse_p is p^-1 mod 2^32.
+//! Outputs may alias the inputs. These are the kernels behind add_n, mul_n and the other
+//! batch functions of number_field, which are the ones to call.
+
+namespace field_kernels {
+
+using word = std::uint32_t;
+
+//! r[i] = a[i] + b[i]
+void add_n(word* r, const word* a, const word* b, std::size_t n, word p);
+
+//! r[i] = a[i] - b[i]
+void sub_n(word* r, const word* a, const word* b, std::size_t n, word p);
+
+//! r[i] = a[i] b[i]
+void mul_n(word* r, const word* a, const word* b, std::size_t n, word p, word inverse_p);
+
+//! r[i] = a[i] b[i] + c[i]
+void fma_n(word* r, const word* a, const word* b, const word* c, std::size_t n, word p, word inverse_p);
+
+//! r[i] = a[i] c
+void scale_n(word* r, const word* a, word c, std::size_t n, word p, word inverse_p);
+
+//! a[0] b[0] + ... + a[n - 1] b[n - 1]
+word dot_product(const word* a, const word* b, std::size_t n, word p, word inverse_p);
+
+//! The kernels are picked on the first call from the CPU features:
+//! "avx512" (AVX-512F, 16 lanes), "avx2" (8 lanes) or "portable"
+const char* kernel_name();
+
+//! Replaces them by those of the given name, for tests and benchmarks. Returns false, keeping
+//! the current ones, if the name is unknown or the CPU lacks the instructions
+bool select_kernels(const char* name);
+
+} // namespace field_kernels
+
+#endif // FIELD_KERNELS_H
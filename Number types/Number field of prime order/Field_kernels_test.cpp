@@ -0,0 +1,67 @@
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Number_field.h"
+#include "Number_field.cpp"
+#include "Field_kernels.h"
+
+//! The batch functions against scalar number_field arithmetic, for odd p < 2^32 which take the
+//! kernels. The lengths are no multiples of 8 or 16 lanes, so the vector kernels run their tails as well
+template<std::size_t p>
+bool check_batch() {
+    using field = number_field<p>;
+
+    std::mt19937_64 random(p);
+    bool result = true;
+
+    for (std::size_t n : {0, 1, 3, 7, 8, 15, 17, 31, 33, 100, 1001}) {
+        std::vector<field> a(n), b(n), c(n), r(n);
+        for (auto& x : a) x = field(random() % p);
+        for (auto& x : b) x = field(random() % p);
+        for (auto& x : c) x = field(random() % p);
+
+        // The largest residues, where sums and products come closest to overflowing
+        if (n > 2) a[n - 1] = b[n - 1] = c[n - 1] = field(p - 1);
+
+        field scale(random() % p), dot(0);
+        for (std::size_t i = 0; i < n; i++) dot += a[i] * b[i];
+
+        add_n(r.data(), a.data(), b.data(), n);
+        for (std::size_t i = 0; i < n; i++) result &= (r[i] == a[i] + b[i]);
+
+        sub_n(r.data(), a.data(), b.data(), n);
+        for (std::size_t i = 0; i < n; i++) result &= (r[i] == a[i] - b[i]);
+
+        mul_n(r.data(), a.data(), b.data(), n);
+        for (std::size_t i = 0; i < n; i++) result &= (r[i] == a[i] * b[i]);
+
+        fma_n(r.data(), a.data(), b.data(), c.data(), n);
+        for (std::size_t i = 0; i < n; i++) result &= (r[i] == a[i] * b[i] + c[i]);
+
+        scale_n(r.data(), a.data(), scale, n);
+        for (std::size_t i = 0; i < n; i++) result &= (r[i] == a[i] * scale);
+
+        result &= (dot_product(a.data(), b.data(), n) == dot);
+
+        // In place
+        r = a;
+        mul_n(r.data(), r.data(), b.data(), n);
+        add_n(r.data(), r.data(), c.data(), n);
+        for (std::size_t i = 0; i < n; i++) result &= (r[i] == a[i] * b[i] + c[i]);
+    }
+
+    return result;
+}
+
+int main() {
+    for (const char* name : {"portable", "avx2", "avx512"}) {
+        if (!field_kernels::select_kernels(name)) {
+            std::cout << name << ": not supported" << std::endl;
+            continue;
+        }
+
+        std::cout << field_kernels::kernel_name() << " mod 3: " << check_batch<3>() << std::endl;
+        std::cout << field_kernels::kernel_name() << " mod 998244353: " << check_batch<998244353>() << std::endl;
+        std::cout << field_kernels::kernel_name() << " mod 2^32 - 5: " << check_batch<4294967291>() << std::endl;
+    }
+}
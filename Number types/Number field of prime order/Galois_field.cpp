@@ -0,0 +1,583 @@
+#include "Galois_field.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+//! Private methods
+
+template<std::size_t p, std::size_t k>
+const typename galois_field<p, k>::context& galois_field<p, k>::shared() {
+    static const context instance = [] {
+        if constexpr (tabulated) return build_tables();
+        else return build_montgomery();
+    }();
+
+    return instance;
+}
+
+template<std::size_t p, std::size_t k>
+typename galois_field<p, k>::context galois_field<p, k>::build_tables() {
+    context result{};
+    result.codes.resize(order - 1);
+
+    // f is primitive exactly when the powers of x first come back to 1 after order - 1 steps,
+    // and then it is irreducible too, as the units of a ring with zero divisors are fewer
+    for (std::uint64_t index = 0;; index++) {
+        std::vector<base> f = candidate(index);
+        if (f[0] == base(0)) continue; // x would divide f
+
+        residue power{};
+        power[0] = base(1);
+
+        bool primitive = true;
+
+        for (std::uint32_t n = 0; n < order - 1 && primitive; n++) {
+            result.codes[n] = code(power);
+            if (n > 0 && result.codes[n] == 1) primitive = false;
+
+            // power *= x, x^k being replaced by -(f_0 + ... + f_(k-1) x^(k-1))
+            base top = power[k - 1];
+            for (std::size_t i = k - 1; i > 0; i--) power[i] = power[i - 1] - top * f[i];
+            power[0] = -(top * f[0]);
+        }
+
+        if (primitive && code(power) == 1) {
+            result.modulus = f;
+            break;
+        }
+    }
+
+    result.logs.assign(order, zero_log);
+    for (std::uint32_t n = 0; n < order - 1; n++) result.logs[result.codes[n]] = n;
+
+    // 1 + x^n differs from x^n in the lowest digit only
+    result.zech.resize(order - 1);
+
+    for (std::uint32_t n = 0; n < order - 1; n++) {
+        std::uint32_t c = result.codes[n];
+        result.zech[n] = result.logs[c % p == p - 1 ? c - (p - 1) : c + 1];
+    }
+
+    result.minus_one_log = result.logs[p - 1];
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+typename galois_field<p, k>::context galois_field<p, k>::build_montgomery() {
+    context result{};
+
+    for (std::uint64_t index = 0;; index++) {
+        result.modulus = candidate(index);
+
+        // f has to be invertible modulo x^k
+        if (result.modulus[0] != base(0) && irreducible(result.modulus)) break;
+    }
+
+    const std::vector<base>& f = result.modulus;
+
+    // f^-1 as a power series: the coefficients of f f^-1 above the constant one vanish
+    residue inverse{};
+    base constant_inverse = f[0].inverse();
+    inverse[0] = constant_inverse;
+
+    for (std::size_t i = 1; i < k; i++) {
+        base sum;
+        for (std::size_t j = 1; j <= i; j++) sum += f[j] * inverse[i - j];
+
+        inverse[i] = -(sum * constant_inverse);
+    }
+
+    for (std::size_t i = 0; i < k; i++) result.negated_inverse[i] = -inverse[i];
+
+    for (std::size_t multiple = 1; multiple <= 3; multiple++) {
+        std::vector<base> monomial(multiple * k + 1);
+        monomial.back() = base(1);
+        reduce_modulo(monomial, f);
+
+        residue& target = (multiple == 1 ? result.r1 : multiple == 2 ? result.r2 : result.r3);
+        for (std::size_t i = 0; i < k; i++) target[i] = monomial[i];
+    }
+
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+void galois_field<p, k>::trim(std::vector<base>& a) {
+    while (!a.empty() && a.back() == base(0)) a.pop_back();
+}
+
+template<std::size_t p, std::size_t k>
+void galois_field<p, k>::reduce_modulo(std::vector<base>& a, const std::vector<base>& f) {
+    for (std::size_t i = a.size(); i-- > k;) {
+        base top = a[i];
+        if (top == base(0)) continue;
+
+        for (std::size_t j = 0; j < k; j++) a[i - k + j] -= top * f[j];
+        a[i] = base(0);
+    }
+
+    a.resize(k);
+}
+
+template<std::size_t p, std::size_t k>
+std::vector<typename galois_field<p, k>::base> galois_field<p, k>::multiply_modulo(const std::vector<base>& a, const std::vector<base>& b,
+                                                                                    const std::vector<base>& f) {
+    std::vector<base> product(a.size() + b.size() - 1);
+
+    for (std::size_t i = 0; i < a.size(); i++) {
+        for (std::size_t j = 0; j < b.size(); j++) product[i + j] += a[i] * b[j];
+    }
+
+    reduce_modulo(product, f);
+    return product;
+}
+
+template<std::size_t p, std::size_t k>
+std::vector<typename galois_field<p, k>::base> galois_field<p, k>::power_modulo(std::vector<base> a, std::uint64_t power,
+                                                                                 const std::vector<base>& f) {
+    std::vector<base> result(k);
+    result[0] = base(1);
+
+    while (power > 0) {
+        if (power & 1) result = multiply_modulo(result, a, f);
+        power >>= 1;
+        if (power) a = multiply_modulo(a, a, f);
+    }
+
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+bool galois_field<p, k>::coprime(std::vector<base> a, std::vector<base> b) {
+    trim(a);
+    trim(b);
+
+    while (!b.empty()) {
+        base lead_inverse = b.back().inverse();
+
+        while (a.size() >= b.size()) {
+            base factor = a.back() * lead_inverse;
+            std::size_t shift = a.size() - b.size();
+
+            for (std::size_t j = 0; j < b.size(); j++) a[shift + j] -= factor * b[j];
+            trim(a);
+        }
+
+        std::swap(a, b);
+    }
+
+    return a.size() == 1;
+}
+
+template<std::size_t p, std::size_t k>
+bool galois_field<p, k>::irreducible(const std::vector<base>& f) {
+    // Rabin's test: f divides x^(p^k) - x, and shares no factor with x^(p^(k/r)) - x for a prime r | k
+    std::vector<base> x{base(0), base(1)};
+    reduce_modulo(x, f);
+
+    std::vector<std::vector<base>> frobenius{x};
+    for (std::size_t j = 1; j <= k; j++) frobenius.push_back(power_modulo(frobenius.back(), p, f));
+
+    if (frobenius[k] != x) return false;
+
+    std::size_t rest = k;
+
+    for (std::size_t r = 2; r <= rest; r++) {
+        if (rest % r) continue;
+        while (rest % r == 0) rest /= r;
+
+        std::vector<base> difference = frobenius[k / r];
+        for (std::size_t i = 0; i < k; i++) difference[i] -= x[i];
+
+        if (!coprime(f, difference)) return false;
+    }
+
+    return true;
+}
+
+template<std::size_t p, std::size_t k>
+std::vector<typename galois_field<p, k>::base> galois_field<p, k>::inverse_modulo(const residue& a, const std::vector<base>& f) {
+    // r = s a mod f along the remainder sequence of f and a
+    std::vector<base> r0 = f, r1(a.begin(), a.end());
+    std::vector<base> s0, s1{base(1)};
+
+    trim(r1);
+    if (r1.empty()) throw std::runtime_error("Division by zero");
+
+    while (!r1.empty()) {
+        base lead_inverse = r1.back().inverse();
+        std::vector<base> quotient(r0.size() >= r1.size() ? r0.size() - r1.size() + 1 : 0);
+
+        while (r0.size() >= r1.size()) {
+            base factor = r0.back() * lead_inverse;
+            std::size_t shift = r0.size() - r1.size();
+
+            quotient[shift] = factor;
+            for (std::size_t j = 0; j < r1.size(); j++) r0[shift + j] -= factor * r1[j];
+            trim(r0);
+        }
+
+        // s0 - quotient s1
+        std::vector<base> s2 = s0;
+        if (!quotient.empty()) s2.resize(std::max(s2.size(), quotient.size() + s1.size() - 1));
+
+        for (std::size_t i = 0; i < quotient.size(); i++) {
+            for (std::size_t j = 0; j < s1.size(); j++) s2[i + j] -= quotient[i] * s1[j];
+        }
+
+        trim(s2);
+
+        std::swap(r0, r1);
+        s0 = std::move(s1);
+        s1 = std::move(s2);
+    }
+
+    // r0 is a nonzero constant, f being irreducible
+    base scale = r0[0].inverse();
+    for (base& coefficient : s0) coefficient *= scale;
+
+    s0.resize(k);
+    return s0;
+}
+
+template<std::size_t p, std::size_t k>
+std::vector<typename galois_field<p, k>::base> galois_field<p, k>::candidate(std::uint64_t index) {
+    std::vector<base> f(k + 1);
+    f[k] = base(1);
+
+    // splitmix64 over the index, all coefficients have to vary from the start: x^3 + c, for
+    // one, is reducible for every c when p = 2 mod 3
+    std::uint64_t state = index * (k + 1);
+
+    for (std::size_t i = 0; i < k; i++) {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+        f[i] = base(z ^ (z >> 31));
+    }
+
+    return f;
+}
+
+template<std::size_t p, std::size_t k>
+std::uint32_t galois_field<p, k>::code(const residue& a) {
+    std::uint32_t result = 0;
+    for (std::size_t i = k; i-- > 0;) result = result * p + static_cast<std::uint32_t>(a[i].get_number());
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+typename galois_field<p, k>::residue galois_field<p, k>::from_code(std::uint32_t number) {
+    residue result{};
+
+    for (std::size_t i = 0; i < k; i++) {
+        result[i] = base(number % p);
+        number /= p;
+    }
+
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+typename galois_field<p, k>::residue galois_field<p, k>::montgomery_reduce(const std::array<base, 2 * k>& t) {
+    const context& field = shared();
+
+    // m = -t f^-1 mod x^k makes the low half of t + m f vanish
+    residue m{};
+
+    for (std::size_t i = 0; i < k; i++) {
+        for (std::size_t j = 0; j <= i; j++) m[i] += t[j] * field.negated_inverse[i - j];
+    }
+
+    // The high half, f being monic: m f = m x^k + m (f - x^k)
+    residue result{};
+
+    for (std::size_t i = 0; i < k; i++) {
+        base sum = t[k + i] + m[i];
+        for (std::size_t j = i + 1; j < k; j++) sum += m[j] * field.modulus[k + i - j];
+
+        result[i] = sum;
+    }
+
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+typename galois_field<p, k>::residue galois_field<p, k>::montgomery_multiply(const residue& a, const residue& b) {
+    std::array<base, 2 * k> product{};
+
+    for (std::size_t i = 0; i < k; i++) {
+        for (std::size_t j = 0; j < k; j++) product[i + j] += a[i] * b[j];
+    }
+
+    return montgomery_reduce(product);
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> galois_field<p, k>::from_residue(const residue& a) {
+    galois_field result;
+
+    if constexpr (tabulated) result.value = shared().logs[code(a)];
+    else result.value = montgomery_multiply(a, shared().r2);
+
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+std::uint32_t galois_field<p, k>::add_logs(std::uint32_t a, std::uint32_t b) {
+    std::uint32_t sum = a + b;
+    return (sum >= order - 1 ? sum - (order - 1) : sum);
+}
+
+//! Rule of five
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>::galois_field() {
+    if constexpr (tabulated) value = zero_log;
+    else value = residue{};
+}
+
+template<std::size_t p, std::size_t k>
+template<typename I, typename>
+galois_field<p, k>::galois_field(I number): galois_field(base(number)) {}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>::galois_field(const base& number) {
+    if constexpr (tabulated) {
+        residue a{};
+        a[0] = number;
+        value = shared().logs[code(a)];
+    }
+    else {
+        // The Montgomery form of a constant c is c x^k mod f
+        const residue& r1 = shared().r1;
+        for (std::size_t i = 0; i < k; i++) value[i] = number * r1[i];
+    }
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>::galois_field(const polynomial<base>& poly) {
+    std::vector<base> a(poly.coef().begin(), poly.coef().end());
+    reduce_modulo(a, shared().modulus);
+
+    residue reduced{};
+    for (std::size_t i = 0; i < k; i++) reduced[i] = a[i];
+
+    value = from_residue(reduced).value;
+}
+
+//! Bool operators
+
+template<std::size_t p, std::size_t k>
+bool galois_field<p, k>::operator==(const galois_field& other) const {
+    return value == other.value;
+}
+
+template<std::size_t p, std::size_t k>
+bool galois_field<p, k>::operator!=(const galois_field& other) const {
+    return !(*this == other);
+}
+
+//! In-class arithmetic operators
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>& galois_field<p, k>::operator+=(const galois_field& other) {
+    if constexpr (tabulated) {
+        if (other.value == zero_log) return *this;
+
+        if (value == zero_log) {
+            value = other.value;
+            return *this;
+        }
+
+        // x^a + x^b = x^a (1 + x^(b - a))
+        std::uint32_t zech = shared().zech[add_logs(other.value, order - 1 - value)];
+        value = (zech == zero_log ? zero_log : add_logs(value, zech));
+    }
+    else {
+        for (std::size_t i = 0; i < k; i++) value[i] += other.value[i];
+    }
+
+    return *this;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>& galois_field<p, k>::operator-=(const galois_field& other) {
+    if constexpr (tabulated) *this += -other;
+    else {
+        for (std::size_t i = 0; i < k; i++) value[i] -= other.value[i];
+    }
+
+    return *this;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>& galois_field<p, k>::operator*=(const galois_field& other) {
+    if constexpr (tabulated) {
+        value = (value == zero_log || other.value == zero_log ? zero_log : add_logs(value, other.value));
+    }
+    else value = montgomery_multiply(value, other.value);
+
+    return *this;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>& galois_field<p, k>::operator/=(const galois_field& other) {
+    *this *= other.inverse();
+    return *this;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k>& galois_field<p, k>::operator^=(std::uint64_t power) {
+    if constexpr (tabulated) {
+        if (value == zero_log) {
+            if (power == 0) value = 0;
+            return *this;
+        }
+
+        value = static_cast<std::uint32_t>(std::uint64_t(value) * (power % (order - 1)) % (order - 1));
+    }
+    else {
+        residue base_power = value;
+        value = shared().r1;
+
+        while (power > 0) {
+            if (power & 1) value = montgomery_multiply(value, base_power);
+            power >>= 1;
+            if (power) base_power = montgomery_multiply(base_power, base_power);
+        }
+    }
+
+    return *this;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> galois_field<p, k>::operator+() const {
+    return *this;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> galois_field<p, k>::operator-() const {
+    galois_field result = *this;
+
+    if constexpr (tabulated) {
+        if (value != zero_log) result.value = add_logs(value, shared().minus_one_log);
+    }
+    else {
+        for (std::size_t i = 0; i < k; i++) result.value[i] = -value[i];
+    }
+
+    return result;
+}
+
+//! Methods
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> galois_field<p, k>::inverse() const {
+    galois_field result;
+
+    if constexpr (tabulated) {
+        if (value == zero_log) throw std::runtime_error("Division by zero");
+        result.value = (value ? order - 1 - value : 0);
+    }
+    else {
+        // The plain inverse of a x^k is a^-1 x^-k, and x^3k brings it back to a^-1 x^k
+        const context& field = shared();
+        std::vector<base> plain = inverse_modulo(value, field.modulus);
+
+        residue inverse{};
+        for (std::size_t i = 0; i < k; i++) inverse[i] = plain[i];
+
+        result.value = montgomery_multiply(inverse, field.r3);
+    }
+
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+typename galois_field<p, k>::residue galois_field<p, k>::coefficients() const {
+    if constexpr (tabulated) return (value == zero_log ? residue{} : from_code(shared().codes[value]));
+    else {
+        std::array<base, 2 * k> t{};
+        for (std::size_t i = 0; i < k; i++) t[i] = value[i];
+
+        return montgomery_reduce(t);
+    }
+}
+
+template<std::size_t p, std::size_t k>
+polynomial<typename galois_field<p, k>::base> galois_field<p, k>::to_polynomial() const {
+    residue a = coefficients();
+
+    std::vector<base> result(a.begin(), a.end());
+    trim(result);
+    if (result.empty()) result.push_back(base(0));
+
+    return polynomial<base>(result);
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> galois_field<p, k>::variable() {
+    return galois_field(polynomial<base>(std::vector<base>{base(0), base(1)}));
+}
+
+template<std::size_t p, std::size_t k>
+polynomial<typename galois_field<p, k>::base> galois_field<p, k>::modulus() {
+    return polynomial<base>(shared().modulus);
+}
+
+//! Out-of-class operators
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> operator+(const galois_field<p, k>& self, const galois_field<p, k>& other) {
+    galois_field<p, k> result = self;
+    result += other;
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> operator-(const galois_field<p, k>& self, const galois_field<p, k>& other) {
+    galois_field<p, k> result = self;
+    result -= other;
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> operator*(const galois_field<p, k>& self, const galois_field<p, k>& other) {
+    galois_field<p, k> result = self;
+    result *= other;
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> operator/(const galois_field<p, k>& self, const galois_field<p, k>& other) {
+    galois_field<p, k> result = self;
+    result /= other;
+    return result;
+}
+
+template<std::size_t p, std::size_t k>
+galois_field<p, k> operator^(galois_field<p, k> self, std::uint64_t power) {
+    self ^= power;
+    return self;
+}
+
+template<std::size_t p, std::size_t k>
+std::ostream& operator<<(std::ostream& out, const galois_field<p, k>& number) {
+    if (number == galois_field<p, k>()) out << 0;
+    else out << number.to_polynomial();
+
+    return out;
+}
+
+//! Reads the k coefficients of 1, x, ..., x^(k - 1)
+template<std::size_t p, std::size_t k>
+std::istream& operator>>(std::istream& in, galois_field<p, k>& number) {
+    std::vector<number_field<p>> coefficients(k);
+    for (number_field<p>& coefficient : coefficients) in >> coefficient;
+
+    if (in) number = galois_field<p, k>(polynomial<number_field<p>>(coefficients));
+    return in;
+}
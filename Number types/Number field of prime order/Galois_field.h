@@ -0,0 +1,150 @@
+#ifndef GALOIS_FIELD_H
+#define GALOIS_FIELD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+#include "Number_field.h"
+#include "Modular.h"
+#include "../../Polynomials/Polynomial.h"
+
+//! The finite field GF(p^k) of polynomials over number_field<p> modulo a monic irreducible
+//! polynomial f of degree k, for a prime p. f is found on first use, the first one of a fixed
+//! pseudo-random sequence that suits the representation:
+//!
+//!     fields of at most 2^16 elements store the discrete logarithm to the base x, f being
+//!     primitive, so multiplication and division add logarithms and addition looks up
+//!     the Zech logarithm log(1 + x^n) in a table built with f
+//!
+//!     larger fields store the k coefficients in Montgomery form a x^k mod f, so a product
+//!     is reduced by two half products with -f^-1 mod x^k instead of a long division
+//!
+//! Division by zero throws std::runtime_error("Division by zero"). Like NTT.h, a composite p
+//! fails to compile
+template<std::size_t p, std::size_t k>
+class galois_field {
+    static_assert(modular::is_prime(p), "galois_field: p must be prime");
+    static_assert(k >= 1, "galois_field: the degree must be at least 1");
+public:
+    using base = number_field<p>;
+
+    //! Coefficients of 1, x, ..., x^(k - 1)
+    using residue = std::array<base, k>;
+
+    static constexpr std::uint64_t table_limit = std::uint64_t(1) << 16;
+private:
+    //! p^k, or 0 above table_limit
+    static constexpr std::uint64_t small_order() {
+        std::uint64_t order = 1;
+
+        for (std::size_t i = 0; i < k; i++) {
+            if (order > table_limit / p) return 0;
+            order *= p;
+        }
+
+        return order;
+    }
+public:
+    static constexpr bool tabulated = (small_order() != 0);
+private:
+    static constexpr std::uint32_t order = static_cast<std::uint32_t>(small_order());
+    static constexpr std::uint32_t zero_log = order - 1; // logarithms of nonzero elements are below
+
+    //! The field polynomial and everything derived from it, built once
+    struct context {
+        std::vector<base> modulus; // monic, of degree k
+
+        //! Tabulated fields: the code of x^n (its coefficients as digits in base p), the
+        //! logarithm of each code and the Zech logarithms
+        std::vector<std::uint32_t> codes;
+        std::vector<std::uint32_t> logs;
+        std::vector<std::uint32_t> zech;
+        std::uint32_t minus_one_log;
+
+        //! Other fields: -f^-1 mod x^k and x^k, x^2k, x^3k mod f
+        residue negated_inverse;
+        residue r1, r2, r3;
+    };
+
+    using storage = std::conditional_t<tabulated, std::uint32_t, residue>;
+
+    storage value;
+
+    static const context& shared();
+    static context build_tables();
+    static context build_montgomery();
+
+    //! Polynomials as coefficient vectors, for the search of f and the conversions
+    static void trim(std::vector<base>& a);
+    static void reduce_modulo(std::vector<base>& a, const std::vector<base>& f);
+    static std::vector<base> multiply_modulo(const std::vector<base>& a, const std::vector<base>& b, const std::vector<base>& f);
+    static std::vector<base> power_modulo(std::vector<base> a, std::uint64_t power, const std::vector<base>& f);
+    static bool coprime(std::vector<base> a, std::vector<base> b);
+    static bool irreducible(const std::vector<base>& f);
+
+    //! a^-1 mod f by the extended Euclidean algorithm, throws for a = 0
+    static std::vector<base> inverse_modulo(const residue& a, const std::vector<base>& f);
+
+    //! The monic polynomial of degree k numbered index in the sequence of candidates for f
+    static std::vector<base> candidate(std::uint64_t index);
+
+    static std::uint32_t code(const residue& a);
+    static residue from_code(std::uint32_t number);
+
+    //! (t + m f) / x^k for the m that makes it exact, so t x^-k mod f, for t of degree below 2k
+    static residue montgomery_reduce(const std::array<base, 2 * k>& t);
+    static residue montgomery_multiply(const residue& a, const residue& b);
+
+    static galois_field from_residue(const residue& a);
+
+    //! Sum of logarithms modulo order - 1
+    static std::uint32_t add_logs(std::uint32_t a, std::uint32_t b);
+public:
+    //! Rule of five
+
+    galois_field();
+
+    //! The constant of number_field<p>
+    template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    galois_field(I number);
+    galois_field(const base& number);
+
+    //! Reduced modulo the field polynomial
+    explicit galois_field(const polynomial<base>& poly);
+
+    //! Bool operators
+
+    bool operator==(const galois_field& other) const;
+    bool operator!=(const galois_field& other) const;
+
+    //! Arithmetic operators
+
+    galois_field& operator+=(const galois_field& other);
+    galois_field& operator-=(const galois_field& other);
+    galois_field& operator*=(const galois_field& other);
+    galois_field& operator/=(const galois_field& other);
+    galois_field& operator^=(std::uint64_t power);
+
+    galois_field operator+() const;
+    galois_field operator-() const;
+
+    //! Methods
+
+    //! Throws std::runtime_error for zero
+    galois_field inverse() const;
+
+    residue coefficients() const;
+    polynomial<base> to_polynomial() const;
+
+    //! The class of x, which generates the multiplicative group of a tabulated field
+    static galois_field variable();
+
+    //! The field polynomial f
+    static polynomial<base> modulus();
+};
+
+#endif // GALOIS_FIELD_H
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <random>
+#include "Number_field.h"
+#include "Number_field.cpp"
+#include "Modular.cpp"
+#include "../../Polynomials/Polynomial.cpp"
+#include "Galois_field.h"
+#include "Galois_field.cpp"
+
+//! Field arithmetic against that of polynomials over number_field<p> reduced modulo the field polynomial
+template<std::size_t p, std::size_t k>
+bool check_field() {
+    using field = galois_field<p, k>;
+    using base = number_field<p>;
+
+    std::mt19937_64 random(p * 100 + k);
+    bool result = true;
+
+    for (int test = 0; test < 50; test++) {
+        std::vector<base> a_coefficients(k), b_coefficients(k);
+        for (auto& x : a_coefficients) x = base(random() % p);
+        for (auto& x : b_coefficients) x = base(random() % p);
+
+        polynomial<base> f(a_coefficients), g(b_coefficients);
+        field a(f), b(g);
+
+        result &= (a + b == field(f + g));
+        result &= (a - b == field(f - g));
+        result &= (a * b == field(f * g));
+        result &= (a.to_polynomial() == field(f).to_polynomial());
+
+        if (b != field(0)) result &= (a / b * b == a && b * b.inverse() == field(1));
+
+        // Fermat's little theorem for p^k elements, by powers of p
+        field frobenius = a;
+        for (std::size_t i = 0; i < k; i++) frobenius ^= p;
+        result &= (frobenius == a);
+    }
+
+    return result;
+}
+
+int main() {
+    std::cout << "GF(2^8), tabulated " << galois_field<2, 8>::tabulated << ": " << check_field<2, 8>() << std::endl;
+    std::cout << "GF(3^5), tabulated " << galois_field<3, 5>::tabulated << ": " << check_field<3, 5>() << std::endl;
+    std::cout << "GF(251^2), tabulated " << galois_field<251, 2>::tabulated << ": " << check_field<251, 2>() << std::endl;
+
+    std::cout << "GF(2^20), tabulated " << galois_field<2, 20>::tabulated << ": " << check_field<2, 20>() << std::endl;
+    std::cout << "GF(7^6), tabulated " << galois_field<7, 6>::tabulated << ": " << check_field<7, 6>() << std::endl;
+    std::cout << "GF(998244353^3), tabulated " << galois_field<998244353, 3>::tabulated << ": " << check_field<998244353, 3>() << std::endl;
+}
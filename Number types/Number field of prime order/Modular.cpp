@@ -0,0 +1,218 @@
+#include "Modular.h"
+
+namespace modular {
+
+using dword = unsigned __int128;
+
+constexpr word multiply(word a, word b, word m) {
+    return static_cast<word>(dword(a) * b % m);
+}
+
+constexpr word power(word a, word e, word m) {
+    word result = 1 % m;
+    a %= m;
+
+    while (e > 0) {
+        if (e & 1) result = multiply(result, a, m);
+        a = multiply(a, a, m);
+        e >>= 1;
+    }
+
+    return result;
+}
+
+constexpr word gcd(word a, word b) {
+    while (b) {
+        word remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+constexpr word inverse(word a, word m) {
+    // The Bezout coefficients alternate in sign, so their magnitudes are tracked with the parity
+    word b = m, x = 1, y = 0;
+    bool negative = false;
+
+    a %= m;
+
+    while (b) {
+        word quotient = a / b;
+
+        word remainder = a - quotient * b;
+        a = b;
+        b = remainder;
+
+        word coefficient = x + quotient * y;
+        x = y;
+        y = coefficient;
+
+        negative = !negative;
+    }
+
+    return negative ? m - x : x;
+}
+
+constexpr int jacobi(word a, word n) {
+    int result = 1;
+    a %= n;
+
+    while (a) {
+        // (2 / n) = -1 exactly for n = 3, 5 mod 8
+        while (a % 2 == 0) {
+            a /= 2;
+            if (n % 8 == 3 || n % 8 == 5) result = -result;
+        }
+
+        // Quadratic reciprocity
+        word rest = n;
+        n = a;
+        a = rest;
+
+        if (a % 4 == 3 && n % 4 == 3) result = -result;
+        a %= n;
+    }
+
+    return n == 1 ? result : 0;
+}
+
+constexpr bool is_prime(word n) {
+    constexpr word bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+    if (n < 2) return false;
+
+    for (word base : bases) {
+        if (n % base == 0) return n == base;
+    }
+
+    word d = n - 1;
+    int s = 0;
+
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+
+    for (word base : bases) {
+        word x = power(base, d, n);
+        if (x == 1 || x == n - 1) continue;
+
+        bool witness = true;
+
+        for (int i = 1; i < s && witness; i++) {
+            x = multiply(x, x, n);
+            if (x == n - 1) witness = false;
+        }
+
+        if (witness) return false;
+    }
+
+    return true;
+}
+
+//! A proper factor of an odd composite n. The gcd is taken once per batch of 64 steps,
+//! on the product of the differences, and the batch is replayed if it overshot to n
+constexpr word rho_factor(word n) {
+    constexpr word batch = 64;
+
+    for (word c = 1;; c++) {
+        auto step = [n, c](word v) { return static_cast<word>((dword(v) * v + c) % n); };
+        auto distance = [](word a, word b) { return a > b ? a - b : b - a; };
+
+        word x = 2, y = 2, saved = 2, product = 1, divisor = 1;
+
+        for (word length = 1; divisor == 1; length *= 2) {
+            x = y;
+            for (word i = 0; i < length; i++) y = step(y);
+
+            for (word done = 0; done < length && divisor == 1; done += batch) {
+                saved = y;
+
+                for (word i = 0; i < batch && done + i < length; i++) {
+                    y = step(y);
+                    product = multiply(product, distance(x, y), n);
+                }
+
+                divisor = gcd(product, n);
+            }
+        }
+
+        if (divisor == n) {
+            do {
+                saved = step(saved);
+                divisor = gcd(distance(x, saved), n);
+            } while (divisor == 1);
+        }
+
+        if (divisor != n) return divisor;
+    }
+}
+
+constexpr factorization prime_factors(word n) {
+    factorization result{};
+
+    auto add = [&result](word q) {
+        for (int i = 0; i < result.count; i++) {
+            if (result.primes[i] == q) return;
+        }
+
+        // Insertion keeps them sorted
+        int i = result.count++;
+        for (; i > 0 && result.primes[i - 1] > q; i--) result.primes[i] = result.primes[i - 1];
+        result.primes[i] = q;
+    };
+
+    for (word d = 2; d < 1000 && d * d <= n; d++) {
+        if (n % d) continue;
+
+        add(d);
+        while (n % d == 0) n /= d;
+    }
+
+    // What is left has no factor below 1000, so at most 6 prime factors with multiplicity
+    word pending[8] = {n};
+    int pending_count = (n > 1);
+
+    while (pending_count > 0) {
+        word m = pending[--pending_count];
+
+        if (is_prime(m)) {
+            add(m);
+            continue;
+        }
+
+        word d = rho_factor(m);
+        pending[pending_count++] = d;
+        pending[pending_count++] = m / d;
+    }
+
+    return result;
+}
+
+constexpr word primitive_root(word p) {
+    if (p == 2) return 1;
+
+    factorization factors = prime_factors(p - 1);
+
+    for (word g = 2;; g++) {
+        bool generator = true;
+
+        for (int i = 0; i < factors.count && generator; i++) {
+            if (power(g, (p - 1) / factors.primes[i], p) == 1) generator = false;
+        }
+
+        if (generator) return g;
+    }
+}
+
+constexpr int two_adicity(word p) {
+    int s = 0;
+
+    for (word rest = p - 1; rest % 2 == 0; rest /= 2) s++;
+
+    return s;
+}
+
+} // namespace modular
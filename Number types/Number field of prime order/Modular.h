@@ -0,0 +1,46 @@
+#ifndef MODULAR_H
+#define MODULAR_H
+
+#include <cstdint>
+
+//! Number theory on 64-bit words, all constexpr so that the properties of the modulus of
+//! number_field<p> (primality, generator, roots of unity) are found by the compiler.
+//! Like the templates, the definitions are in Modular.cpp, which users include as well
+
+namespace modular {
+
+using word = std::uint64_t;
+
+//! a b mod m and a^e mod m, for m > 0
+constexpr word multiply(word a, word b, word m);
+constexpr word power(word a, word e, word m);
+
+constexpr word gcd(word a, word b);
+
+//! a^-1 mod m for gcd(a, m) = 1 and m > 1, by the extended Euclidean algorithm
+constexpr word inverse(word a, word m);
+
+//! The Jacobi symbol (a / n) for an odd n, which is the Legendre symbol when n is prime
+constexpr int jacobi(word a, word n);
+
+//! Miller-Rabin with the prime bases up to 37, which is exact for every 64-bit n
+constexpr bool is_prime(word n);
+
+//! The distinct prime factors of n in increasing order, at most 15 for a 64-bit n
+struct factorization {
+    word primes[15];
+    int count;
+};
+
+//! By trial division up to 1000, then Pollard's rho in Brent's variant, for n >= 1
+constexpr factorization prime_factors(word n);
+
+//! The smallest generator of the multiplicative group modulo a prime p
+constexpr word primitive_root(word p);
+
+//! The largest s with 2^s dividing p - 1, so the order of the roots of unity of power-of-two order, for p > 1
+constexpr int two_adicity(word p);
+
+} // namespace modular
+
+#endif // MODULAR_H
@@ -0,0 +1,90 @@
+#include <iostream>
+#include "Number_field.h"
+#include "Number_field.cpp"
+#include "Modular.h"
+#include "Modular.cpp"
+#include "NTT.h"
+#include "NTT.cpp"
+#include "../../Polynomials/Polynomial.cpp"
+
+// Evaluated by the compiler
+static_assert(modular::is_prime(998244353) && !modular::is_prime(3215031751ull));
+static_assert(modular::is_prime(18446744073709551557ull) && !modular::is_prime(18446744073709551555ull));
+static_assert(modular::primitive_root(998244353) == 3 && modular::primitive_root(1000000007) == 5);
+static_assert(modular::two_adicity(998244353) == 23 && modular::two_adicity(65537) == 16);
+static_assert(ntt_roots<998244353>::roots[1] == number_field<998244353>(998244352));
+
+//! Primality and the smallest primitive root against trial division, up to limit
+bool check_small(std::uint64_t limit) {
+    bool result = true;
+
+    for (std::uint64_t n = 2; n < limit; n++) {
+        bool prime = true;
+        for (std::uint64_t d = 2; d * d <= n; d++) prime &= (n % d != 0);
+
+        result &= (modular::is_prime(n) == prime);
+        if (!prime) continue;
+
+        // The smallest g whose powers reach every nonzero residue
+        std::uint64_t generator = 1;
+
+        for (std::uint64_t g = 1; g < n && generator == 1 && n > 2; g++) {
+            std::uint64_t order = 1, power = g;
+            while (power != 1) {
+                power = power * g % n;
+                order++;
+            }
+
+            if (order == n - 1) generator = g;
+        }
+
+        result &= (modular::primitive_root(n) == generator);
+    }
+
+    return result;
+}
+
+//! The factorization multiplies back to n, with every factor prime
+bool check_factors(std::uint64_t n) {
+    modular::factorization factors = modular::prime_factors(n);
+    std::uint64_t rest = n;
+
+    for (int i = 0; i < factors.count; i++) {
+        if (!modular::is_prime(factors.primes[i]) || rest % factors.primes[i] != 0) return false;
+        while (rest % factors.primes[i] == 0) rest /= factors.primes[i];
+    }
+
+    return rest == 1;
+}
+
+//! roots[k] has order exactly 2^k, and inverse_roots[k] is its inverse
+template<std::size_t p>
+bool check_roots() {
+    using roots = ntt_roots<p>;
+    using field = number_field<p>;
+
+    bool result = ((roots::generator ^ ((p - 1) / 2)) == field(p - 1));
+
+    for (int k = 0; k <= roots::two_adicity; k++) {
+        field power = roots::roots[k];
+        for (int i = 0; i < k; i++) power *= power;
+
+        result &= (power == field(1) && (k == 0 || (roots::roots[k] ^ (std::uint64_t(1) << (k - 1))) == field(p - 1)));
+        result &= (roots::roots[k] * roots::inverse_roots[k] == field(1));
+        result &= (roots::inverse_sizes[k] * field(std::uint64_t(1) << k) == field(1));
+    }
+
+    return result;
+}
+
+int main() {
+    std::cout << "primes and primitive roots below 3000: " << check_small(3000) << std::endl;
+    std::cout << "factors of 2^64 - 1: " << check_factors(18446744073709551615ull) << std::endl;
+    std::cout << "factors of 2^61 - 2: " << check_factors(2305843009213693950ull) << std::endl;
+    std::cout << "factors of 4295098369 (65537^2): " << check_factors(4295098369ull) << std::endl;
+    std::cout << "factors of 998244359987710471 (998244353 1000000007): " << check_factors(998244359987710471ull) << std::endl;
+
+    std::cout << "roots mod 998244353: " << check_roots<998244353>() << std::endl;
+    std::cout << "roots mod 65537: " << check_roots<65537>() << std::endl;
+    std::cout << "roots mod 2^64 - 2^32 + 1: " << check_roots<18446744069414584321ull>() << std::endl;
+}
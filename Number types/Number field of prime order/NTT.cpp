@@ -0,0 +1,401 @@
+#include "NTT.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+template<std::size_t p>
+number_field<p> primitive_root() {
+    return ntt_roots<p>::generator;
+}
+
+template<std::size_t p>
+const number_field<p>* twiddle_table(int bits, bool inverse) {
+    using roots = ntt_roots<p>;
+    using table = std::vector<number_field<p>>;
+
+    if (bits <= roots::table_bits) return (inverse ? roots::inverse_twiddles : roots::twiddles).data();
+
+    // Tables only ever grow, and the outgrown ones are kept, so a pointer handed out stays valid
+    static std::mutex lock;
+    static std::vector<std::unique_ptr<table>> tables[2];
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<std::unique_ptr<table>>& grown = tables[inverse];
+
+    if (grown.empty() || grown.back()->size() < (std::size_t(1) << bits)) {
+        const auto& stored = (inverse ? roots::inverse_twiddles : roots::twiddles);
+        const auto& steps = (inverse ? roots::inverse_roots : roots::roots);
+
+        auto result = std::make_unique<table>(std::size_t(1) << bits);
+        std::copy(stored.begin(), stored.end(), result->begin());
+
+        for (int k = roots::table_bits + 1; k <= bits; k++) {
+            std::size_t half = std::size_t(1) << (k - 1);
+            (*result)[half] = number_field<p>(1);
+
+            for (std::size_t j = 1; j < half; j++) (*result)[half + j] = (*result)[half + j - 1] * steps[k];
+        }
+
+        grown.push_back(std::move(result));
+    }
+
+    return grown.back()->data();
+}
+
+template<std::size_t p>
+int transform_bits(std::size_t n) {
+    int bits = 0;
+    while ((std::size_t(1) << bits) < n) bits++;
+
+    if ((n & (n - 1)) || bits > ntt_roots<p>::two_adicity) throw std::invalid_argument("ntt: unsupported transform length");
+
+    return bits;
+}
+
+//! The arithmetic of the butterflies, on number_field<p> itself, or for the odd p stored in 32 bits on
+//! their storage words, with the Montgomery reduction spelled out on 32-bit constants, which is
+//! the form the compiler vectorizes
+template<std::size_t p, bool words = (p % 2 == 1 && sizeof(number_field<p>) == sizeof(std::uint32_t))>
+struct butterfly_arithmetic {
+    using value = number_field<p>;
+
+    static value add(value a, value b) { return a + b; }
+    static value sub(value a, value b) { return a - b; }
+    static value multiply(value a, value b) { return a * b; }
+
+    static value* storage(number_field<p>* a) { return a; }
+    static const value* storage(const number_field<p>* a) { return a; }
+};
+
+template<std::size_t p>
+struct butterfly_arithmetic<p, true> {
+    using value = std::uint32_t;
+
+    static constexpr value modulus = static_cast<value>(p);
+    static constexpr value inverse = [] {
+        value x = modulus;
+        for (int i = 0; i < 5; i++) x *= 2 - modulus * x;
+        return x;
+    }();
+
+    static value add(value a, value b) {
+        value complement = modulus - b;
+        return a - complement + (modulus & -static_cast<value>(a < complement));
+    }
+
+    static value sub(value a, value b) {
+        return a - b + (modulus & -static_cast<value>(a < b));
+    }
+
+    static value multiply(value a, value b) {
+        std::uint64_t t = std::uint64_t(a) * b;
+        value m = static_cast<value>(t) * inverse;
+        value high = static_cast<value>(t >> 32);
+        value subtrahend = static_cast<value>(std::uint64_t(m) * modulus >> 32);
+
+        return high - subtrahend + (modulus & -static_cast<value>(high < subtrahend));
+    }
+
+    static value* storage(number_field<p>* a) { return field_storage(a); }
+    static const value* storage(const number_field<p>* a) { return field_storage(a); }
+};
+
+//! The kernels below are vectorized for each instruction set, the loader picking the clone.
+//! The parts of the arrays they combine come as separate pointers, which never alias, as
+//! the compiler needs to know
+
+//! Two radix-2 stages of ntt_dif at once, of lengths m = 4 q and m / 2, over n / m blocks
+//! with the quarters a0, ..., a3, w1[j] = w^j and w2[j] = w^(2j) for the root w of order m.
+//! t3 takes the twiddle w^q of the second half, and the twiddles of the shorter stage are the
+//! squares. A fixed q lets the loop over the blocks be vectorized when q is too short for its own
+template<typename arithmetic, std::size_t fixed_q = 0, typename value = typename arithmetic::value>
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-loop-vectorize")))
+#endif
+void dif_butterflies(value* __restrict a0, value* __restrict a1, value* __restrict a2, value* __restrict a3,
+                     std::size_t n, std::size_t q, const value* w1, const value* w2, value imaginary) {
+    if constexpr (fixed_q != 0) q = fixed_q;
+
+    for (std::size_t start = 0; start < n; start += 4 * q) {
+        for (std::size_t j = 0; j < q; j++) {
+            std::size_t i = start + j;
+
+            value t0 = arithmetic::add(a0[i], a2[i]), t1 = arithmetic::sub(a0[i], a2[i]);
+            value t2 = arithmetic::add(a1[i], a3[i]), t3 = arithmetic::multiply(arithmetic::sub(a1[i], a3[i]), imaginary);
+
+            a0[i] = arithmetic::add(t0, t2);
+            a1[i] = arithmetic::multiply(arithmetic::sub(t0, t2), w2[j]);
+            a2[i] = arithmetic::multiply(arithmetic::add(t1, t3), w1[j]);
+            a3[i] = arithmetic::multiply(arithmetic::sub(t1, t3), arithmetic::multiply(w1[j], w2[j]));
+        }
+    }
+}
+
+//! The butterflies of dif_butterflies run backwards, with the inverse twiddles
+template<typename arithmetic, std::size_t fixed_q = 0, typename value = typename arithmetic::value>
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-loop-vectorize")))
+#endif
+void dit_butterflies(value* __restrict a0, value* __restrict a1, value* __restrict a2, value* __restrict a3,
+                     std::size_t n, std::size_t q, const value* w1, const value* w2, value imaginary) {
+    if constexpr (fixed_q != 0) q = fixed_q;
+
+    for (std::size_t start = 0; start < n; start += 4 * q) {
+        for (std::size_t j = 0; j < q; j++) {
+            std::size_t i = start + j;
+
+            value x1 = arithmetic::multiply(a1[i], w2[j]);
+            value x2 = arithmetic::multiply(a2[i], w1[j]);
+            value x3 = arithmetic::multiply(a3[i], arithmetic::multiply(w1[j], w2[j]));
+
+            value t0 = arithmetic::add(a0[i], x1), t1 = arithmetic::sub(a0[i], x1);
+            value t2 = arithmetic::add(x2, x3), t3 = arithmetic::multiply(arithmetic::sub(x2, x3), imaginary);
+
+            a0[i] = arithmetic::add(t0, t2);
+            a1[i] = arithmetic::add(t1, t3);
+            a2[i] = arithmetic::sub(t0, t2);
+            a3[i] = arithmetic::sub(t1, t3);
+        }
+    }
+}
+
+//! The radix-2 stage over the whole array, halves a0 and a1, w[j] = w^j for the root w of order
+//! 2 half. It goes first in ntt_dif when the number of stages is odd, and last in ntt_dit
+template<typename arithmetic, bool inverse, typename value = typename arithmetic::value>
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-loop-vectorize")))
+#endif
+void radix2_butterflies(value* __restrict a0, value* __restrict a1, std::size_t half, const value* w) {
+    for (std::size_t j = 0; j < half; j++) {
+        if constexpr (inverse) {
+            value v = arithmetic::multiply(a1[j], w[j]);
+
+            a1[j] = arithmetic::sub(a0[j], v);
+            a0[j] = arithmetic::add(a0[j], v);
+        } else {
+            value difference = arithmetic::sub(a0[j], a1[j]);
+
+            a0[j] = arithmetic::add(a0[j], a1[j]);
+            a1[j] = arithmetic::multiply(difference, w[j]);
+        }
+    }
+}
+
+//! r[i] = r[i] b[i], and r[i] = r[i] f
+template<typename arithmetic, typename value = typename arithmetic::value>
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-loop-vectorize")))
+#endif
+void multiply_pointwise(value* __restrict r, const value* __restrict b, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) r[i] = arithmetic::multiply(r[i], b[i]);
+}
+
+template<typename arithmetic, typename value = typename arithmetic::value>
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-loop-vectorize")))
+#endif
+void scale(value* __restrict r, value f, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) r[i] = arithmetic::multiply(r[i], f);
+}
+
+//! The radix-4 stage of blocks of 2^level elements
+template<std::size_t p, bool inverse>
+void radix4_stage(number_field<p>* values, std::size_t n, int level, const number_field<p>* table) {
+    using arithmetic = butterfly_arithmetic<p>;
+    using value = typename arithmetic::value;
+
+    const number_field<p> imaginary = (inverse ? ntt_roots<p>::inverse_roots : ntt_roots<p>::roots)[2];
+    const value i = *arithmetic::storage(&imaginary);
+
+    std::size_t m = std::size_t(1) << level, q = m / 4;
+    const value* w1 = arithmetic::storage(table + m / 2);
+    const value* w2 = arithmetic::storage(table + m / 4);
+    value* a = arithmetic::storage(values);
+
+    // The stages run on blocks of 4 elements or more, and of 16 or more with no radix-2 one in between
+    auto butterflies = (inverse ? dit_butterflies<arithmetic> : dif_butterflies<arithmetic>);
+    if (q == 1) butterflies = (inverse ? dit_butterflies<arithmetic, 1> : dif_butterflies<arithmetic, 1>);
+    if (q == 4) butterflies = (inverse ? dit_butterflies<arithmetic, 4> : dif_butterflies<arithmetic, 4>);
+
+    butterflies(a, a + q, a + 2 * q, a + 3 * q, n, q, w1, w2, i);
+}
+
+template<std::size_t p>
+void ntt_dif(number_field<p>* values, std::size_t n) {
+    using arithmetic = butterfly_arithmetic<p>;
+
+    int bits = transform_bits<p>(n);
+    if (bits == 0) return;
+
+    const number_field<p>* table = twiddle_table<p>(bits, false);
+    int level = bits;
+
+    // An odd number of stages starts with a radix-2 one, so the radix-4 ones keep blocks of 4^k
+    if (bits % 2) {
+        radix2_butterflies<arithmetic, false>(arithmetic::storage(values), arithmetic::storage(values + n / 2),
+                                              n / 2, arithmetic::storage(table + n / 2));
+        level--;
+    }
+
+    for (; level >= 2; level -= 2) radix4_stage<p, false>(values, n, level, table);
+}
+
+template<std::size_t p>
+void ntt_dit(number_field<p>* values, std::size_t n) {
+    using arithmetic = butterfly_arithmetic<p>;
+
+    int bits = transform_bits<p>(n);
+    if (bits == 0) return;
+
+    const number_field<p>* table = twiddle_table<p>(bits, true);
+
+    for (int level = 2; level <= bits; level += 2) radix4_stage<p, true>(values, n, level, table);
+
+    if (bits % 2) {
+        radix2_butterflies<arithmetic, true>(arithmetic::storage(values), arithmetic::storage(values + n / 2),
+                                             n / 2, arithmetic::storage(table + n / 2));
+    }
+
+    scale<arithmetic>(arithmetic::storage(values), *arithmetic::storage(&ntt_roots<p>::inverse_sizes[bits]), n);
+}
+
+template<std::size_t p>
+void ntt(std::vector<number_field<p>>& values, bool inverse) {
+    std::size_t n = values.size();
+    transform_bits<p>(n);
+
+    if (n <= 1) return;
+
+    if (!inverse) ntt_dif(values.data(), n);
+
+    for (std::size_t i = 1, j = 0; i < n; i++) {
+        std::size_t bit = n >> 1;
+
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+
+        if (i < j) std::swap(values[i], values[j]);
+    }
+
+    if (inverse) ntt_dit(values.data(), n);
+}
+
+//! The primes behind the convolutions that are too long for p, all with two_adicity >= 23
+constexpr std::size_t crt_prime1 = 998244353;
+constexpr std::size_t crt_prime2 = 469762049;
+constexpr std::size_t crt_prime3 = 167772161;
+
+template<std::size_t p>
+bool direct_convolution(std::size_t size) {
+    std::size_t n = 1;
+    while (n < size) n <<= 1;
+
+    return (n >> ntt_roots<p>::two_adicity) == 0;
+}
+
+template<std::size_t p>
+bool fast_convolution(std::size_t a_size, std::size_t b_size) {
+    if (a_size == 0 || b_size == 0 || direct_convolution<p>(a_size + b_size - 1)) return true;
+
+    // The exact integer products, each below min(a_size, b_size) (p - 1)^2, must fit the CRT
+    constexpr unsigned __int128 crt_product = static_cast<unsigned __int128>(crt_prime1) * crt_prime2 * crt_prime3;
+    constexpr unsigned __int128 square = static_cast<unsigned __int128>(p - 1) * (p - 1);
+
+    if constexpr (p > (std::size_t(1) << 43)) return false;
+    else return direct_convolution<crt_prime1>(a_size + b_size - 1) && square * std::min(a_size, b_size) < crt_product;
+}
+
+template<std::size_t q, std::size_t p>
+std::vector<number_field<q>> convolution_modulo(const std::vector<number_field<p>>& a, const std::vector<number_field<p>>& b) {
+    std::vector<number_field<q>> a_residues(a.size()), b_residues(b.size());
+
+    for (std::size_t i = 0; i < a.size(); i++) a_residues[i] = number_field<q>(a[i].get_number());
+    for (std::size_t i = 0; i < b.size(); i++) b_residues[i] = number_field<q>(b[i].get_number());
+
+    return convolution(std::move(a_residues), std::move(b_residues));
+}
+
+template<std::size_t p>
+std::vector<number_field<p>> convolution(std::vector<number_field<p>> a, std::vector<number_field<p>> b) {
+    if (a.empty() || b.empty()) return {};
+
+    std::size_t result_size = a.size() + b.size() - 1;
+
+    if (!direct_convolution<p>(result_size)) {
+        if constexpr (p == crt_prime1 || p == crt_prime2 || p == crt_prime3) {
+            throw std::invalid_argument("ntt: unsupported transform length");
+        } else {
+            if (!fast_convolution<p>(a.size(), b.size())) throw std::invalid_argument("ntt: unsupported transform length");
+
+            using field2 = number_field<crt_prime2>;
+            using field3 = number_field<crt_prime3>;
+
+            std::vector<number_field<crt_prime1>> product1 = convolution_modulo<crt_prime1>(a, b);
+            std::vector<field2> product2 = convolution_modulo<crt_prime2>(a, b);
+            std::vector<field3> product3 = convolution_modulo<crt_prime3>(a, b);
+
+            // Garner's algorithm: x = x1 + p1 t2 + p1 p2 t3, then taken modulo p
+            const field2 inverse1 = field2(crt_prime1).inverse();
+            const field3 inverse12 = (field3(crt_prime1) * field3(crt_prime2)).inverse();
+            const number_field<p> weight1(crt_prime1), weight12 = weight1 * number_field<p>(crt_prime2);
+
+            std::vector<number_field<p>> result(result_size);
+
+            for (std::size_t i = 0; i < result_size; i++) {
+                std::uint64_t x1 = product1[i].get_number();
+
+                std::uint64_t t2 = ((product2[i] - field2(x1)) * inverse1).get_number();
+                std::uint64_t x12 = x1 + crt_prime1 * t2;
+
+                std::uint64_t t3 = ((product3[i] - field3(x12)) * inverse12).get_number();
+
+                result[i] = number_field<p>(x1) + weight1 * number_field<p>(t2) + weight12 * number_field<p>(t3);
+            }
+
+            return result;
+        }
+    }
+
+    std::size_t n = 1;
+    while (n < result_size) n <<= 1;
+
+    a.resize(n);
+    b.resize(n);
+
+    // Bit-reversed order in between, which the pointwise product does not mind
+    ntt_dif(a.data(), n);
+    ntt_dif(b.data(), n);
+
+    using arithmetic = butterfly_arithmetic<p>;
+    multiply_pointwise<arithmetic>(arithmetic::storage(a.data()), arithmetic::storage(b.data()), n);
+
+    ntt_dit(a.data(), n);
+    a.resize(result_size);
+
+    return a;
+}
+
+template<std::size_t p>
+polynomial<number_field<p>> operator*(const polynomial<number_field<p>>& self, const polynomial<number_field<p>>& other) {
+    // A composite p has no roots of unity to transform with
+    if constexpr (!modular::is_prime(p)) {
+        return schoolbook_product(self, other);
+    } else {
+        std::size_t shorter = std::min(self.coef().size(), other.coef().size());
+
+        if (shorter < ntt_polynomial_threshold || !fast_convolution<p>(self.coef().size(), other.coef().size())) {
+            return schoolbook_product(self, other);
+        }
+
+        polynomial<number_field<p>> result(number_field<p>(0));
+        result.coef() = convolution(self.coef(), other.coef());
+
+        while (result.coef().size() > 1 && result.coef().back() == number_field<p>(0)) result.coef().pop_back();
+
+        return result;
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef NTT_H
+#define NTT_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Number_field.h"
+#include "Modular.h"
+#include "../../Polynomials/Polynomial.h"
+
+//! Number-theoretic transform over number_field<p> for a prime p.
+//! The transform length must be a power of two dividing p - 1.
+
+//! The roots behind the transforms, all evaluated by the compiler, so a transform starts
+//! without any setup. A composite p fails to compile
+template<std::size_t p>
+struct ntt_roots {
+    static_assert(modular::is_prime(p), "ntt_roots: p must be prime");
+
+    using field = number_field<p>;
+
+    //! The smallest primitive root
+    static constexpr field generator = field(modular::primitive_root(p));
+
+    //! p - 1 = 2^two_adicity m with m odd, the longest transform has 2^two_adicity elements
+    static constexpr int two_adicity = modular::two_adicity(p);
+
+    //! roots[k] has order 2^k, inverse_roots[k] is its inverse
+    static constexpr std::array<field, two_adicity + 1> roots = [] {
+        std::array<field, two_adicity + 1> result{};
+        result[two_adicity] = generator ^ ((p - 1) >> two_adicity);
+
+        for (int k = two_adicity; k > 0; k--) result[k - 1] = result[k] * result[k];
+
+        return result;
+    }();
+
+    static constexpr std::array<field, two_adicity + 1> inverse_roots = [] {
+        std::array<field, two_adicity + 1> result{};
+        for (int k = 0; k <= two_adicity; k++) result[k] = roots[k].inverse();
+        return result;
+    }();
+
+    //! inverse_sizes[k] = 2^-k, the scale of an inverse transform of 2^k elements
+    static constexpr std::array<field, two_adicity + 1> inverse_sizes = [] {
+        std::array<field, two_adicity + 1> result{};
+        result[0] = field(1);
+
+        for (int k = 1; k <= two_adicity; k++) result[k] = result[k - 1] * field(p / 2 + 1);
+
+        return result;
+    }();
+
+    //! The stages of up to 2^table_bits elements read their twiddles from here: the stage of
+    //! length m uses twiddles[m / 2 + j] = roots[log m]^j for j < m / 2. Longer transforms,
+    //! whose tables would bloat the binary, get them from twiddle_table
+    static constexpr int table_bits = (two_adicity < 11 ? two_adicity : 11);
+
+    static constexpr std::array<field, (std::size_t(1) << table_bits)> twiddle_table(const std::array<field, two_adicity + 1>& from) {
+        std::array<field, (std::size_t(1) << table_bits)> result{};
+
+        for (int k = 1; k <= table_bits; k++) {
+            std::size_t half = std::size_t(1) << (k - 1);
+            result[half] = field(1);
+
+            for (std::size_t j = 1; j < half; j++) result[half + j] = result[half + j - 1] * from[k];
+        }
+
+        return result;
+    }
+
+    static constexpr std::array<field, (std::size_t(1) << table_bits)> twiddles = twiddle_table(roots);
+    static constexpr std::array<field, (std::size_t(1) << table_bits)> inverse_twiddles = twiddle_table(inverse_roots);
+};
+
+template<std::size_t p>
+number_field<p> primitive_root();
+
+//! The twiddles of every stage of a transform of 2^bits elements, laid out as ntt_roots::twiddles.
+//! Past table_bits they are computed at the first such transform and shared from then on
+template<std::size_t p>
+const number_field<p>* twiddle_table(int bits, bool inverse);
+
+//! In place, by radix-4 butterflies, with a radix-2 one left for an odd number of stages.
+//! ntt_dif takes the values in order and leaves the transform in bit-reversed order,
+//! ntt_dit takes it back to the values, scaled by 1 / n, so a convolution needs no reordering
+template<std::size_t p>
+void ntt_dif(number_field<p>* values, std::size_t n);
+
+template<std::size_t p>
+void ntt_dit(number_field<p>* values, std::size_t n);
+
+//! The transform in order, or its inverse
+template<std::size_t p>
+void ntt(std::vector<number_field<p>>& values, bool inverse = false);
+
+//! Whether convolution takes operands of these sizes: either p has roots of unity for the
+//! length, or the products are found modulo three NTT primes and brought back by the CRT,
+//! which works as long as their integer values, below min(a_size, b_size) (p - 1)^2, stay under ~2^86
+template<std::size_t p>
+bool fast_convolution(std::size_t a_size, std::size_t b_size);
+
+//! Linear (acyclic) convolution of a and b, the result has all a.size() + b.size() - 1 elements.
+//! Throws std::invalid_argument unless fast_convolution holds
+template<std::size_t p>
+std::vector<number_field<p>> convolution(std::vector<number_field<p>> a, std::vector<number_field<p>> b);
+
+//! Polynomials with at least this many coefficients each are multiplied by convolution
+constexpr std::size_t ntt_polynomial_threshold = 32;
+
+//! The product of polynomials over number_field<p>, which takes over from the generic one of
+//! Polynomial.cpp, and falls back to schoolbook_product for short factors, for a composite p
+//! or when convolution can't do it
+template<std::size_t p>
+polynomial<number_field<p>> operator*(const polynomial<number_field<p>>& self, const polynomial<number_field<p>>& other);
+
+#endif // NTT_H
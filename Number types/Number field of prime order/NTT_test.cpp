@@ -0,0 +1,51 @@
+#include <iostream>
+#include <random>
+#include "Number_field.h"
+#include "Number_field.cpp"
+#include "Modular.cpp"
+#include "NTT.h"
+#include "NTT.cpp"
+#include "../../Polynomials/Polynomial.cpp"
+
+//! NTT products against the double loop, for sizes above ntt_polynomial_threshold
+template<std::size_t p>
+bool check_product(std::size_t a_size, std::size_t b_size) {
+    std::mt19937_64 random(a_size * 1000003 + b_size);
+    std::vector<number_field<p>> a(a_size), b(b_size);
+
+    for (auto& x : a) x = number_field<p>(random() % p);
+    for (auto& x : b) x = number_field<p>(random() % p);
+
+    polynomial<number_field<p>> f(a), g(b);
+
+    // The largest values give the largest integer products on the CRT path
+    f[0] = g[b_size - 1] = number_field<p>(p - 1);
+
+    return f * g == schoolbook_product(f, g);
+}
+
+template<std::size_t p>
+bool check_round_trip(std::size_t n) {
+    std::vector<number_field<p>> values(n);
+    for (std::size_t i = 0; i < n; i++) values[i] = number_field<p>(i * i + 7);
+
+    std::vector<number_field<p>> copy = values;
+    ntt(copy);
+    ntt(copy, true);
+
+    return copy == values;
+}
+
+int main() {
+    std::cout << "round trip mod 998244353: " << check_round_trip<998244353>(1 << 12) << std::endl;
+    std::cout << "round trip mod 65537: " << check_round_trip<65537>(1 << 15) << std::endl;
+
+    std::cout << "product mod 998244353: " << check_product<998244353>(1000, 700) << std::endl;
+    std::cout << "product mod 7340033: " << check_product<7340033>(33, 2048) << std::endl;
+
+    // 10^9 + 7 has no roots of unity of these orders and goes through three NTT primes
+    std::cout << "product mod 1000000007: " << check_product<1000000007>(500, 501) << std::endl;
+
+    // A composite modulus is multiplied by the double loop
+    std::cout << "product mod 10: " << check_product<10>(100, 100) << std::endl;
+}
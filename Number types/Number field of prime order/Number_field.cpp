@@ -1,33 +1,77 @@
 #include "Number_field.h"
+#include "Field_kernels.h"
+
+#include <stdexcept>
+#include <vector>
+
+//! Private methods
+
+template<std::size_t p>
+constexpr typename number_field<p>::word number_field<p>::reduce(dword t) {
+    word m = static_cast<word>(t) * inverse_p;
+    word high = static_cast<word>(t >> word_bits);
+    word subtrahend = static_cast<word>(dword(m) * p >> word_bits);
+
+    return high - subtrahend + (static_cast<word>(p) & -static_cast<word>(high < subtrahend));
+}
+
+template<std::size_t p>
+constexpr typename number_field<p>::word number_field<p>::multiply(word a, word b) {
+    if constexpr (montgomery) return reduce(dword(a) * b);
+    else return static_cast<word>(dword(a) * b % p);
+}
+
+template<std::size_t p>
+constexpr typename number_field<p>::word number_field<p>::to_form(word x) {
+    if constexpr (montgomery) return reduce(dword(x) * r2_mod_p);
+    else return x;
+}
+
+template<std::size_t p>
+constexpr typename number_field<p>::word number_field<p>::from_form(word x) {
+    if constexpr (montgomery) return reduce(x);
+    else return x;
+}
 
 //! Rule of five
 
 template <std::size_t p>
-number_field<p>::number_field(): number(0) {}
+constexpr number_field<p>::number_field(): number(0) {}
 
-template <std::size_t p>
-number_field<p>::number_field(int _number) {
-    if (_number >= 0) number = _number % p;
-    else number = p - (abs(_number) % p);
+template<std::size_t p>
+template<typename I, typename>
+constexpr number_field<p>::number_field(I _number): number(0) {
+    // The magnitude as unsigned, so that the most negative value is fine too
+    std::make_unsigned_t<I> magnitude = static_cast<std::make_unsigned_t<I>>(_number);
+    bool negative = false;
+
+    if constexpr (std::is_signed_v<I>) {
+        negative = (_number < 0);
+        if (negative) magnitude = static_cast<std::make_unsigned_t<I>>(0 - magnitude);
+    }
+
+    word residue = static_cast<word>(magnitude % p);
+    if (negative && residue) residue = static_cast<word>(p) - residue;
+
+    number = static_cast<value_type>(to_form(residue));
 }
 
 template<std::size_t p>
-number_field<p>::number_field(const number_field<p>& other): number(other.number) {}
+constexpr number_field<p>::number_field(const number_field<p>& other): number(other.number) {}
 
 template<std::size_t p>
-number_field<p>::number_field(number_field<p>&& other) noexcept {
-    number = other.number;
+constexpr number_field<p>::number_field(number_field<p>&& other) noexcept: number(other.number) {
     other.number = 0;
 }
 
 template<std::size_t p>
-number_field<p>& number_field<p>::operator=(const number_field<p>& other) {
+constexpr number_field<p>& number_field<p>::operator=(const number_field<p>& other) {
     number = other.number;
     return *this;
 }
 
 template<std::size_t p>
-number_field<p>& number_field<p>::operator=(number_field<p>&& other) noexcept {
+constexpr number_field<p>& number_field<p>::operator=(number_field<p>&& other) noexcept {
     number = other.number;
     other.number = 0;
     return *this;
@@ -36,131 +80,243 @@ number_field<p>& number_field<p>::operator=(number_field<p>&& other) noexcept {
 //! Bool operators
 
 template<std::size_t p>
-bool number_field<p>::operator<(const number_field<p>& other) const {
-    return number < other.number;
+constexpr bool number_field<p>::operator<(const number_field<p>& other) const {
+    return get_number() < other.get_number();
 }
 
 template<std::size_t p>
-bool number_field<p>::operator>(const number_field<p>& other) const {
+constexpr bool number_field<p>::operator>(const number_field<p>& other) const {
     return other < *this;
 }
 
 template<std::size_t p>
-bool number_field<p>::operator<=(const number_field<p>& other) const {
+constexpr bool number_field<p>::operator<=(const number_field<p>& other) const {
     return !(*this > other);
 }
 
 template<std::size_t p>
-bool number_field<p>::operator>=(const number_field<p>& other) const {
+constexpr bool number_field<p>::operator>=(const number_field<p>& other) const {
     return !(*this < other);
 }
 
 template<std::size_t p>
-bool number_field<p>::operator==(const number_field<p>& other) const {
-    return (*this <= other) && (*this >= other);
+constexpr bool number_field<p>::operator==(const number_field<p>& other) const {
+    // The storage form is a bijection, no conversion needed
+    return number == other.number;
 }
 
 template<std::size_t p>
-bool number_field<p>::operator!=(const number_field<p>& other) const {
+constexpr bool number_field<p>::operator!=(const number_field<p>& other) const {
     return !(other == *this);
 }
 
 //! In-class arithmetic operators
 
 template<std::size_t p>
-number_field<p>& number_field<p>::operator+=(const number_field<p>& other) {
-    int result = number + other.number;
-    *this = number_field<p>(result);
+constexpr number_field<p>& number_field<p>::operator+=(const number_field<p>& other) {
+    // a + b - p computed as a - (p - b), which cannot overflow, then p added back on borrow
+    word a = number, complement = static_cast<word>(p) - other.number;
+    word result = a - complement;
 
+    number = static_cast<value_type>(result + (static_cast<word>(p) & -static_cast<word>(a < complement)));
     return *this;
 }
 
 template<std::size_t p>
-number_field<p>& number_field<p>::operator-=(const number_field<p>& other) {
-    int result = number - other.number;
-    *this = number_field<p>(result);
+constexpr number_field<p>& number_field<p>::operator-=(const number_field<p>& other) {
+    word a = number, b = other.number;
+    word result = a - b;
 
+    number = static_cast<value_type>(result + (static_cast<word>(p) & -static_cast<word>(a < b)));
     return *this;
 }
 
 template<std::size_t p>
-number_field<p>& number_field<p>::operator*=(const number_field<p>& other) {
-    int result = number * other.number;
-    *this = number_field<p>(result);
-
+constexpr number_field<p>& number_field<p>::operator*=(const number_field<p>& other) {
+    number = static_cast<value_type>(multiply(number, other.number));
     return *this;
 }
 
 template<std::size_t p>
-number_field<p>& number_field<p>::operator/=(const number_field<p>& other) {
+constexpr number_field<p>& number_field<p>::operator/=(const number_field<p>& other) {
     *this *= other.inverse();
     return *this;
 }
 
 template <std::size_t p>
-number_field<p> &number_field<p>::operator^=(int power) {
+constexpr number_field<p>& number_field<p>::operator^=(std::uint64_t power) {
     *this = (*this) ^ power;
     return *this;
 }
 
 template <std::size_t p>
-number_field<p> number_field<p>::operator+() const {
-    return number_field();
+constexpr number_field<p> number_field<p>::operator+() const {
+    return *this;
 }
 
 template <std::size_t p>
-number_field<p> number_field<p>::operator-() const {
-    return number_field(-number);
+constexpr number_field<p> number_field<p>::operator-() const {
+    return number_field() - *this;
 }
 
 //! Methods
 
 template<std::size_t p>
-number_field<p> number_field<p>::inverse() const {
-    for (int i = 1; i < p; i++) {
-        if (i * number % p == 1) return number_field<p>(i);
+constexpr number_field<p> number_field<p>::inverse() const {
+    // The Bezout coefficients of a alternate in sign, so their magnitudes are tracked in words
+    // (they stay below p) together with the parity of the step count
+    word a = get_number(), b = static_cast<word>(p);
+    word x = 1, y = 0;
+    bool negative = false;
+
+    while (b) {
+        word quotient = a / b;
+
+        word remainder = a - quotient * b;
+        a = b;
+        b = remainder;
+
+        word coefficient = x + quotient * y;
+        x = y;
+        y = coefficient;
+
+        negative = !negative;
+    }
+
+    if (a != 1) throw std::runtime_error("Division by zero");
+    if (negative) x = static_cast<word>(p) - x;
+
+    number_field<p> result;
+    result.number = static_cast<value_type>(to_form(x));
+    return result;
+}
+
+template<std::size_t p>
+constexpr typename number_field<p>::word number_field<p>::get_number() const {
+    return from_form(number);
+}
+
+//! Out-of-class functions
+
+template<std::size_t p>
+void batch_inverse(number_field<p>* first, number_field<p>* last) {
+    std::size_t n = last - first;
+    if (!n) return;
+
+    // prefix[i] = first[0] ... first[i], so one inversion of the whole product serves every element
+    std::vector<number_field<p>> prefix(n);
+    prefix[0] = first[0];
+
+    for (std::size_t i = 1; i < n; i++) prefix[i] = prefix[i - 1] * first[i];
+
+    number_field<p> inverse = prefix[n - 1].inverse();
+
+    for (std::size_t i = n - 1; i > 0; i--) {
+        number_field<p> value = first[i];
+
+        first[i] = inverse * prefix[i - 1];
+        inverse *= value;
+    }
+
+    first[0] = inverse;
+}
+
+//! The kernels read the arrays as their 32-bit storage words
+template<std::size_t p>
+field_kernels::word* field_storage(number_field<p>* a) {
+    static_assert(sizeof(number_field<p>) == sizeof(field_kernels::word), "number_field: unexpected layout");
+    return reinterpret_cast<field_kernels::word*>(a);
+}
+
+template<std::size_t p>
+const field_kernels::word* field_storage(const number_field<p>* a) {
+    static_assert(sizeof(number_field<p>) == sizeof(field_kernels::word), "number_field: unexpected layout");
+    return reinterpret_cast<const field_kernels::word*>(a);
+}
+
+template<std::size_t p>
+void add_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, std::size_t n) {
+    if constexpr (number_field<p>::vectorized) field_kernels::add_n(field_storage(r), field_storage(a), field_storage(b), n, p);
+    else for (std::size_t i = 0; i < n; i++) r[i] = a[i] + b[i];
+}
+
+template<std::size_t p>
+void sub_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, std::size_t n) {
+    if constexpr (number_field<p>::vectorized) field_kernels::sub_n(field_storage(r), field_storage(a), field_storage(b), n, p);
+    else for (std::size_t i = 0; i < n; i++) r[i] = a[i] - b[i];
+}
+
+template<std::size_t p>
+void mul_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, std::size_t n) {
+    if constexpr (number_field<p>::vectorized) {
+        field_kernels::mul_n(field_storage(r), field_storage(a), field_storage(b), n, p, number_field<p>::inverse_p);
     }
+    else for (std::size_t i = 0; i < n; i++) r[i] = a[i] * b[i];
+}
 
-    throw std::runtime_error("Division by zero");
+template<std::size_t p>
+void fma_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, const number_field<p>* c, std::size_t n) {
+    if constexpr (number_field<p>::vectorized) {
+        field_kernels::fma_n(field_storage(r), field_storage(a), field_storage(b), field_storage(c), n, p, number_field<p>::inverse_p);
+    }
+    else for (std::size_t i = 0; i < n; i++) r[i] = a[i] * b[i] + c[i];
 }
 
 template<std::size_t p>
-int number_field<p>::get_number() const {
-    return number;
+void scale_n(number_field<p>* r, const number_field<p>* a, const number_field<p>& c, std::size_t n) {
+    // c is copied first, it may be an element of r
+    number_field<p> factor = c;
+
+    if constexpr (number_field<p>::vectorized) {
+        field_kernels::scale_n(field_storage(r), field_storage(a), factor.number, n, p, number_field<p>::inverse_p);
+    }
+    else for (std::size_t i = 0; i < n; i++) r[i] = a[i] * factor;
+}
+
+template<std::size_t p>
+number_field<p> dot_product(const number_field<p>* a, const number_field<p>* b, std::size_t n) {
+    number_field<p> result;
+
+    if constexpr (number_field<p>::vectorized) {
+        result.number = field_kernels::dot_product(field_storage(a), field_storage(b), n, p, number_field<p>::inverse_p);
+    }
+    else for (std::size_t i = 0; i < n; i++) result += a[i] * b[i];
+
+    return result;
 }
 
 //! Out-of-class operators
 
 template<std::size_t p>
-number_field<p> operator+(const number_field<p>& self, const number_field<p>& other) {
+constexpr number_field<p> operator+(const number_field<p>& self, const number_field<p>& other) {
     number_field<p> result = self;
     result += other;
     return result;
 }
 
 template<std::size_t p>
-number_field<p> operator-(const number_field<p>& self, const number_field<p>& other) {
+constexpr number_field<p> operator-(const number_field<p>& self, const number_field<p>& other) {
     number_field<p> result = self;
     result -= other;
     return result;
 }
 
 template<std::size_t p>
-number_field<p> operator*(const number_field<p>& self, const number_field<p>& other) {
+constexpr number_field<p> operator*(const number_field<p>& self, const number_field<p>& other) {
     number_field<p> result = self;
     result *= other;
     return result;
 }
 
 template<std::size_t p>
-number_field<p> operator/(const number_field<p>& self, const number_field<p>& other) {
+constexpr number_field<p> operator/(const number_field<p>& self, const number_field<p>& other) {
     number_field<p> result = self;
     result /= other;
     return result;
 }
 
 template<std::size_t p>
-number_field<p> operator^(number_field<p> self, int power) {
+constexpr number_field<p> operator^(number_field<p> self, std::uint64_t power) {
     number_field<p> result = number_field<p>(1);
 
     while (power > 0) {
@@ -180,9 +336,17 @@ std::ostream& operator<<(std::ostream& out, const number_field<p>& num) {
 
 template<std::size_t p>
 std::istream& operator>>(std::istream& in, number_field<p>& num) {
-    int n;
-    in >> n;
-    num = number_field<p>(n);
+    // Unsigned unless there is a minus, so that residues of 64-bit moduli can be read
+    in >> std::ws;
+
+    if (in.peek() == '-') {
+        long long n;
+        if (in >> n) num = number_field<p>(n);
+    }
+    else {
+        unsigned long long n;
+        if (in >> n) num = number_field<p>(n);
+    }
 
     return in;
-}
\ No newline at end of file
+}
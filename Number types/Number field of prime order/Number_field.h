@@ -2,50 +2,142 @@
 #define NUMBER_FIELD_H
 
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
 #include <fstream>
+#include <type_traits>
 
+//! Residues modulo p, for any p up to 2^64 - 1. Values are stored in the smallest unsigned
+//! type that holds p - 1 and computed on in a machine word (32 bits below 2^32, else 64).
+//!
+//! For odd p the value is kept in Montgomery form x R mod p, R being 2^32 or 2^64, so a
+//! product is reduced with two word multiplications instead of a division. Even p use
+//! the plain remainder, which the compiler turns into a multiplication as p is a constant.
+//! Addition and subtraction are branchless, and all of the arithmetic is constexpr
 template<std::size_t p>
 class number_field {
+    static_assert(p >= 2, "number_field: the modulus must be at least 2");
+public:
+    using word = std::conditional_t<(p <= 0xffffffffull), std::uint32_t, std::uint64_t>;
+    using value_type = std::conditional_t<(p <= 0x100), std::uint8_t,
+                       std::conditional_t<(p <= 0x10000), std::uint16_t, word>>;
 private:
-    int number;
+    using dword = std::conditional_t<(p <= 0xffffffffull), std::uint64_t, unsigned __int128>;
+
+    static constexpr int word_bits = 8 * sizeof(word);
+    static constexpr bool montgomery = (p % 2 == 1);
+
+    //! p^-1 mod R by Newton's iteration, each step doubles the correct low bits
+    static constexpr word modulus_inverse() {
+        word x = static_cast<word>(p);
+        for (int i = 0; i < 5; i++) x *= 2 - static_cast<word>(p) * x;
+        return x;
+    }
+
+    static constexpr word inverse_p = modulus_inverse();
+    static constexpr word r_mod_p = static_cast<word>((dword(1) << word_bits) % p);  // R mod p
+    static constexpr word r2_mod_p = static_cast<word>(dword(r_mod_p) * r_mod_p % p); // R^2 mod p
+
+    value_type number; // Montgomery form for odd p
+
+    //! t R^-1 mod p for t < p R: the low words of t and m p agree, so only the high ones are subtracted
+    static constexpr word reduce(dword t);
+
+    //! a b mod p for stored values, in the storage form
+    static constexpr word multiply(word a, word b);
+
+    //! Residue of x < p into the storage form and back
+    static constexpr word to_form(word x);
+    static constexpr word from_form(word x);
+
+    //! Odd moduli stored in 32 bits go through the vector kernels of Field_kernels.h
+    static constexpr bool vectorized = montgomery && std::is_same_v<value_type, std::uint32_t>;
+
+    template<std::size_t q> friend void add_n(number_field<q>*, const number_field<q>*, const number_field<q>*, std::size_t);
+    template<std::size_t q> friend void sub_n(number_field<q>*, const number_field<q>*, const number_field<q>*, std::size_t);
+    template<std::size_t q> friend void mul_n(number_field<q>*, const number_field<q>*, const number_field<q>*, std::size_t);
+    template<std::size_t q> friend void fma_n(number_field<q>*, const number_field<q>*, const number_field<q>*,
+                                              const number_field<q>*, std::size_t);
+    template<std::size_t q> friend void scale_n(number_field<q>*, const number_field<q>*, const number_field<q>&, std::size_t);
+    template<std::size_t q> friend number_field<q> dot_product(const number_field<q>*, const number_field<q>*, std::size_t);
 public:
     //! Rule of five
 
-    number_field();
-    number_field(int number);
-    number_field(const number_field& other);
-    number_field(number_field&& other) noexcept;
+    constexpr number_field();
+
+    //! Any built-in integer, reduced into [0, p) like a mathematical residue
+    template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    constexpr number_field(I number);
 
-    number_field& operator=(const number_field& other);
-    number_field& operator=(number_field&& other) noexcept;
+    constexpr number_field(const number_field& other);
+    constexpr number_field(number_field&& other) noexcept;
+
+    constexpr number_field& operator=(const number_field& other);
+    constexpr number_field& operator=(number_field&& other) noexcept;
 
     ~number_field() = default;
 
     //! Bool operators
 
-    bool operator<(const number_field& other) const;
-    bool operator>(const number_field& other) const;
-    bool operator<=(const number_field& other) const;
-    bool operator>=(const number_field& other) const;
-    bool operator==(const number_field& other) const;
-    bool operator!=(const number_field& other) const;
+    constexpr bool operator<(const number_field& other) const;
+    constexpr bool operator>(const number_field& other) const;
+    constexpr bool operator<=(const number_field& other) const;
+    constexpr bool operator>=(const number_field& other) const;
+    constexpr bool operator==(const number_field& other) const;
+    constexpr bool operator!=(const number_field& other) const;
 
     //! Arithmetic operators
 
-    number_field& operator+=(const number_field& other);
-    number_field& operator*=(const number_field& other);
-    number_field& operator-=(const number_field& other);
-    number_field& operator/=(const number_field& other);
-    number_field& operator^=(int power);
+    constexpr number_field& operator+=(const number_field& other);
+    constexpr number_field& operator*=(const number_field& other);
+    constexpr number_field& operator-=(const number_field& other);
+    constexpr number_field& operator/=(const number_field& other);
+    constexpr number_field& operator^=(std::uint64_t power);
 
-    number_field operator+() const;
-    number_field operator-() const;
+    constexpr number_field operator+() const;
+    constexpr number_field operator-() const;
 
     //! Methods
 
-    number_field inverse() const;
-    int get_number() const;
+    //! By the extended Euclidean algorithm, throws std::runtime_error if there is none
+    constexpr number_field inverse() const;
+
+    //! The residue in [0, p)
+    constexpr word get_number() const;
 };
 
-#endif // NUMBER_FIELD_H
\ No newline at end of file
+//! Replaces every element of [first, last) by its inverse with a single inversion and 3 (n - 1)
+//! multiplications (Montgomery's trick). Throws std::runtime_error, leaving the range untouched,
+//! if any element has no inverse
+template<std::size_t p>
+void batch_inverse(number_field<p>* first, number_field<p>* last);
+
+//! Element-wise arithmetic over arrays of n elements, r may alias any of the inputs.
+//! For odd p < 2^32 stored in 32 bits (the NTT primes among them) they run on AVX-512 or
+//! AVX2 when the CPU has them, and then Field_kernels.cpp has to be compiled in
+
+//! r[i] = a[i] + b[i]
+template<std::size_t p>
+void add_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, std::size_t n);
+
+//! r[i] = a[i] - b[i]
+template<std::size_t p>
+void sub_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, std::size_t n);
+
+//! r[i] = a[i] b[i]
+template<std::size_t p>
+void mul_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, std::size_t n);
+
+//! r[i] = a[i] b[i] + c[i]
+template<std::size_t p>
+void fma_n(number_field<p>* r, const number_field<p>* a, const number_field<p>* b, const number_field<p>* c, std::size_t n);
+
+//! r[i] = a[i] c
+template<std::size_t p>
+void scale_n(number_field<p>* r, const number_field<p>* a, const number_field<p>& c, std::size_t n);
+
+//! a[0] b[0] + ... + a[n - 1] b[n - 1]
+template<std::size_t p>
+number_field<p> dot_product(const number_field<p>* a, const number_field<p>* b, std::size_t n);
+
+#endif // NUMBER_FIELD_H
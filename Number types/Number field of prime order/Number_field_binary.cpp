@@ -0,0 +1,21 @@
+#include "Number_field_binary.h"
+
+#include <stdexcept>
+
+template<std::size_t p>
+void write_binary(binary_writer& writer, const number_field<p>& value) {
+    writer.put(static_cast<std::uint64_t>(value.get_number()));
+}
+
+template<std::size_t p>
+void read_binary(binary_reader& reader, number_field<p>& value) {
+    std::uint64_t residue = reader.get();
+    if (residue >= p) throw std::runtime_error("binary: malformed number_field");
+
+    value = number_field<p>(residue);
+}
+
+template<std::size_t p>
+void skip_binary(binary_reader& reader, binary_tag<number_field<p>>) {
+    reader.take(1);
+}
@@ -0,0 +1,18 @@
+#ifndef NUMBER_FIELD_BINARY_H
+#define NUMBER_FIELD_BINARY_H
+
+#include "Number_field.h"
+#include "../Big_int/Binary.h"
+
+//! Binary format of number_field<p>, see Binary.h: one word, the residue in [0, p)
+
+template<std::size_t p>
+void write_binary(binary_writer& writer, const number_field<p>& value);
+
+template<std::size_t p>
+void read_binary(binary_reader& reader, number_field<p>& value);
+
+template<std::size_t p>
+void skip_binary(binary_reader& reader, binary_tag<number_field<p>>);
+
+#endif // NUMBER_FIELD_BINARY_H
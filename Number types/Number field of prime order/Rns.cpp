@@ -0,0 +1,484 @@
+#include "Rns.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "Field_kernels.h"
+#include "Modular.h"
+#include "Modular.cpp"
+#include "../Big_int/Limbs.h"
+#include "../Big_int/Thread_pool.h"
+
+namespace {
+
+using word = rns_basis::word;
+using dword = std::uint64_t;
+using limb = limbs::limb;
+
+//! Below this many residues touched, an operation stays on the calling thread
+constexpr std::size_t parallel_work = std::size_t(1) << 16;
+
+//! The scalar arithmetic of the kernels, a b 2^-32 mod p for a b < p 2^32
+
+word subtract(word a, word b, word p) {
+    return a - b + (p & -static_cast<word>(a < b));
+}
+
+word multiply(word a, word b, word p, word inverse_p) {
+    dword t = dword(a) * b;
+    word m = static_cast<word>(t) * inverse_p;
+    word high = static_cast<word>(t >> 32);
+    word subtrahend = static_cast<word>(dword(m) * p >> 32);
+
+    return high - subtrahend + (p & -static_cast<word>(high < subtrahend));
+}
+
+//! r[i] = (r[i] + digit) 2^-32 mod p[i], a Montgomery reduction with no product. The moduli
+//! differ from lane to lane, which the kernels do not cover, so the compiler vectorizes it
+//! for each instruction set and the loader picks the clone
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-loop-vectorize")))
+#endif
+void fold_digit(word* __restrict r, word digit, const word* __restrict p, const word* __restrict inverse_p, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+        dword t = dword(r[i]) + digit;
+        word m = static_cast<word>(t) * inverse_p[i];
+        word high = static_cast<word>(t >> 32);
+        word subtrahend = static_cast<word>(dword(m) * p[i] >> 32);
+
+        r[i] = high - subtrahend + (p[i] & -static_cast<word>(high < subtrahend));
+    }
+}
+
+//! body(first, last) over consecutive ranges covering [0, n), one per thread of
+//! limbs::thread_count() when work residues are touched in total, on the pool of the bigint products
+void for_ranges(std::size_t n, std::size_t work, const std::function<void(std::size_t, std::size_t)>& body) {
+    std::size_t ranges = std::min(limbs::thread_count(), n);
+    thread_pool* pool = (work < parallel_work || ranges <= 1 ? nullptr : limbs::shared_thread_pool());
+
+    if (!pool) {
+        body(0, n);
+        return;
+    }
+
+    task_group group(*pool);
+
+    for (std::size_t t = 1; t < ranges; t++) {
+        group.run([&body, n, ranges, t] { body(n * t / ranges, n * (t + 1) / ranges); });
+    }
+
+    body(0, n / ranges);
+    group.wait();
+}
+
+} // namespace
+
+//! rns_basis
+
+//! Private methods
+
+void rns_basis::fold(const limb* magnitude, std::size_t length, std::size_t first, std::size_t last, word* result) const {
+    // From the lowest 32-bit digit up, r = (r + digit) 2^-32, so the n digits give x 2^-32n
+    std::fill(result, result + (last - first), 0);
+
+    for (std::size_t j = 0; j < 2 * length; j++) {
+        word digit = static_cast<word>(magnitude[j / 2] >> (32 * (j % 2)));
+        fold_digit(result, digit, primes.data() + first, inverses.data() + first, last - first);
+    }
+
+    // Times 2^(32 (n + 2)), the Montgomery form of 2^(32 (n + 1)), to get x 2^32
+    for (std::size_t i = first; i < last; i++) {
+        word p = primes[i], inverse_p = inverses[i];
+        word power = multiply(1, r2[i], p, inverse_p), base = r2[i];
+
+        for (std::uint64_t e = 2 * length + 1; e > 0; e >>= 1) {
+            if (e & 1) power = multiply(power, base, p, inverse_p);
+            base = multiply(base, base, p, inverse_p);
+        }
+
+        result[i - first] = multiply(result[i - first], power, p, inverse_p);
+    }
+}
+
+bigint rns_basis::garner(const word* residues, std::size_t block) const {
+    std::size_t first = block_starts[block], size = block_starts[block + 1] - first;
+    std::vector<word> digits(size);
+
+    // x = d_0 + p_0 d_1 + p_0 p_1 d_2 + ... over the primes of the block, so the digits below i
+    // give x mod p_i as a dot product with the radices, and d_i makes up the difference
+    for (std::size_t i = 0; i < size; i++) {
+        std::size_t prime = first + i;
+        word p = primes[prime], inverse_p = inverses[prime];
+
+        word lower = field_kernels::dot_product(digits.data(), garner_radices.data() + radix_offsets[prime], i, p, inverse_p);
+        digits[i] = multiply(subtract(residues[i], lower, p), garner_inverses[prime], p, inverse_p);
+    }
+
+    // Horner's rule from the top digit, the value grows by at most a limb per two primes
+    limb_buffer magnitude(size / 2 + 2);
+    limb* x = magnitude.data();
+    std::size_t length = 0;
+
+    for (std::size_t i = size; i-- > 0;) {
+        limb carry = limbs::mul_1(x, x, length, primes[first + i]);
+        if (carry) x[length++] = carry;
+
+        limb digit = digits[i];
+
+        for (std::size_t j = 0; digit; j++) {
+            if (j == length) length++;
+
+            x[j] += digit;
+            digit = (x[j] < digit);
+        }
+    }
+
+    bigint result;
+    result._limbs() = limb_buffer(x, x + length);
+
+    return result;
+}
+
+//! Rule of five
+
+rns_basis::rns_basis(const std::vector<word>& moduli): primes(moduli) {
+    if (primes.empty()) throw std::invalid_argument("rns_basis: no primes");
+
+    for (word p : primes) {
+        if (p < 3 || p % 2 == 0 || !modular::is_prime(p)) throw std::invalid_argument("rns_basis: the moduli must be odd primes");
+    }
+
+    std::vector<word> sorted = primes;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) throw std::invalid_argument("rns_basis: the primes must be distinct");
+
+    std::size_t k = primes.size();
+
+    for (word p : primes) {
+        word inverse_p = p;
+        for (int i = 0; i < 4; i++) inverse_p *= 2 - p * inverse_p;
+
+        inverses.push_back(inverse_p);
+        r2.push_back(static_cast<word>(modular::power(2, 64, p)));
+    }
+
+    // Blocks of equal sizes
+    std::size_t blocks = (k + garner_limit - 1) / garner_limit;
+    for (std::size_t b = 0; b <= blocks; b++) block_starts.push_back(k * b / blocks);
+
+    radix_offsets.resize(k);
+    garner_inverses.resize(k);
+
+    for (std::size_t b = 0; b < blocks; b++) {
+        std::size_t first = block_starts[b];
+
+        for (std::size_t i = first; i < block_starts[b + 1]; i++) {
+            word p = primes[i];
+            radix_offsets[i] = garner_radices.size();
+
+            std::uint64_t radix = 1;
+
+            for (std::size_t j = first; j < i; j++) {
+                garner_radices.push_back(multiply(static_cast<word>(radix), r2[i], p, inverses[i]));
+                radix = modular::multiply(radix, primes[j], p);
+            }
+
+            garner_inverses[i] = multiply(static_cast<word>(modular::inverse(radix, p)), r2[i], p, inverses[i]);
+        }
+    }
+
+    // The product of the primes outside the block of p_i, modulo p_i. multiply(x, p_j) is
+    // x p_j 2^-32, so n factors pick up 2^-32n, undone at the end
+    cofactor_inverses.resize(k);
+
+    for_ranges(k, blocks > 1 ? k * k : 0, [this, blocks](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            word p = primes[i], inverse_p = inverses[i];
+            word product = 1 % p;
+            std::uint64_t factors = 0;
+
+            for (std::size_t b = 0; b < blocks; b++) {
+                if (block_starts[b] <= i && i < block_starts[b + 1]) continue;
+
+                for (std::size_t j = block_starts[b]; j < block_starts[b + 1]; j++) product = multiply(product, primes[j], p, inverse_p);
+                factors += block_starts[b + 1] - block_starts[b];
+            }
+
+            std::uint64_t cofactor = modular::multiply(product, modular::power(2, 32 * (factors % (p - 1)), p), p);
+            cofactor_inverses[i] = static_cast<word>(modular::inverse(cofactor, p));
+        }
+    });
+
+    levels.emplace_back();
+
+    for (std::size_t b = 0; b < blocks; b++) {
+        bigint product = 1;
+        for (std::size_t i = block_starts[b]; i < block_starts[b + 1]; i++) product *= static_cast<long long>(primes[i]);
+
+        levels[0].push_back(std::move(product));
+    }
+
+    while (levels.back().size() > 1) {
+        const std::vector<bigint>& below = levels.back();
+        std::vector<bigint> above;
+
+        for (std::size_t j = 0; j + 1 < below.size(); j += 2) above.push_back(below[j] * below[j + 1]);
+        if (below.size() % 2) above.push_back(below.back());
+
+        levels.push_back(std::move(above));
+    }
+
+    half_product = product() / 2;
+}
+
+rns_basis rns_basis::largest_primes(std::size_t count) {
+    std::vector<word> result;
+
+    for (word candidate = 0xffffffffu; result.size() < count; candidate -= 2) {
+        if (modular::is_prime(candidate)) result.push_back(candidate);
+    }
+
+    return rns_basis(result);
+}
+
+rns_basis rns_basis::for_bits(std::size_t bits) {
+    // Every prime below 2^32 taken here exceeds 2^31, and M has to exceed 2^(bits + 1)
+    return largest_primes(bits / 31 + 1);
+}
+
+//! Methods
+
+std::size_t rns_basis::size() const {
+    return primes.size();
+}
+
+rns_basis::word rns_basis::prime(std::size_t index) const {
+    return primes[index];
+}
+
+const bigint& rns_basis::product() const {
+    return levels.back()[0];
+}
+
+void rns_basis::reduce(const bigint& x, word* residues, std::size_t stride) const {
+    std::size_t k = primes.size();
+    std::vector<word> result(k);
+
+    if (levels.size() == 1) {
+        fold(x._limbs().data(), x._limbs().size(), 0, k, result.data());
+    } else {
+        // Down the remainder tree, x mod the product of each node
+        std::vector<bigint> remainders = {x.abs()};
+
+        for (std::size_t level = levels.size() - 1; level-- > 0;) {
+            const std::vector<bigint>& products = levels[level];
+            std::vector<bigint> below(products.size());
+
+            for (std::size_t j = 0; j < products.size(); j++) {
+                const bigint& above = remainders[j / 2];
+                below[j] = (above < products[j] ? above : above % products[j]);
+            }
+
+            remainders = std::move(below);
+        }
+
+        for (std::size_t b = 0; b < remainders.size(); b++) {
+            const limb_buffer& magnitude = remainders[b]._limbs();
+            fold(magnitude.data(), magnitude.size(), block_starts[b], block_starts[b + 1], result.data() + block_starts[b]);
+        }
+    }
+
+    for (std::size_t i = 0; i < k; i++) residues[i * stride] = (x._sign() < 0 ? subtract(0, result[i], primes[i]) : result[i]);
+}
+
+bigint rns_basis::reconstruct(const word* residues, std::size_t stride) const {
+    std::size_t k = primes.size();
+    std::vector<word> scaled(k);
+
+    for (std::size_t i = 0; i < k; i++) scaled[i] = multiply(residues[i * stride], cofactor_inverses[i], primes[i], inverses[i]);
+
+    // A node of the tree is left M_right + right M_left, M_node being the product below it
+    std::vector<bigint> values;
+    for (std::size_t b = 0; b + 1 < block_starts.size(); b++) values.push_back(garner(scaled.data() + block_starts[b], b));
+
+    for (std::size_t level = 0; level + 1 < levels.size(); level++) {
+        const std::vector<bigint>& products = levels[level];
+        std::vector<bigint> combined((values.size() + 1) / 2);
+
+        for (std::size_t j = 0; j + 1 < values.size(); j += 2) {
+            combined[j / 2] = values[j] * products[j + 1] + values[j + 1] * products[j];
+        }
+
+        if (values.size() % 2) combined.back() = std::move(values.back());
+
+        values = std::move(combined);
+    }
+
+    // The sum of the blocks is below their count times M
+    bigint x = (levels.size() > 1 ? values[0] % product() : std::move(values[0]));
+    if (x > half_product) x -= product();
+
+    return x;
+}
+
+//! rns_vector
+
+//! Private methods
+
+void rns_vector::check(const rns_vector& other) const {
+    if (basis != other.basis || count != other.count) throw std::invalid_argument("rns_vector: the operands differ in basis or size");
+}
+
+rns_vector::word* rns_vector::plane(std::size_t index) {
+    return planes.data() + index * count;
+}
+
+const rns_vector::word* rns_vector::plane(std::size_t index) const {
+    return planes.data() + index * count;
+}
+
+//! Rule of five
+
+rns_vector::rns_vector(const rns_basis& basis, std::size_t count):
+    basis(&basis), count(count), planes(basis.size() * count) {}
+
+rns_vector::rns_vector(const rns_basis& basis, const std::vector<bigint>& values): rns_vector(basis, values.size()) {
+    for_ranges(count, count * basis.size(), [this, &values](std::size_t first, std::size_t last) {
+        for (std::size_t j = first; j < last; j++) set(j, values[j]);
+    });
+}
+
+//! Arithmetic operators
+
+rns_vector& rns_vector::operator+=(const rns_vector& other) {
+    check(other);
+
+    for_ranges(basis->size(), planes.size(), [this, &other](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) field_kernels::add_n(plane(i), plane(i), other.plane(i), count, basis->primes[i]);
+    });
+
+    return *this;
+}
+
+rns_vector& rns_vector::operator-=(const rns_vector& other) {
+    check(other);
+
+    for_ranges(basis->size(), planes.size(), [this, &other](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) field_kernels::sub_n(plane(i), plane(i), other.plane(i), count, basis->primes[i]);
+    });
+
+    return *this;
+}
+
+rns_vector& rns_vector::operator*=(const rns_vector& other) {
+    check(other);
+
+    for_ranges(basis->size(), planes.size(), [this, &other](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            field_kernels::mul_n(plane(i), plane(i), other.plane(i), count, basis->primes[i], basis->inverses[i]);
+        }
+    });
+
+    return *this;
+}
+
+rns_vector& rns_vector::operator*=(const bigint& factor) {
+    std::vector<word> residues(basis->size());
+    basis->reduce(factor, residues.data());
+
+    for_ranges(basis->size(), planes.size(), [this, &residues](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            field_kernels::scale_n(plane(i), plane(i), residues[i], count, basis->primes[i], basis->inverses[i]);
+        }
+    });
+
+    return *this;
+}
+
+rns_vector rns_vector::operator-() const {
+    rns_vector result(*basis, count);
+    return result -= *this;
+}
+
+//! Methods
+
+rns_vector& rns_vector::add_product(const rns_vector& a, const rns_vector& b) {
+    check(a);
+    check(b);
+
+    for_ranges(basis->size(), planes.size(), [this, &a, &b](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            field_kernels::fma_n(plane(i), a.plane(i), b.plane(i), plane(i), count, basis->primes[i], basis->inverses[i]);
+        }
+    });
+
+    return *this;
+}
+
+std::size_t rns_vector::size() const {
+    return count;
+}
+
+const rns_basis& rns_vector::base() const {
+    return *basis;
+}
+
+bigint rns_vector::get(std::size_t index) const {
+    return basis->reconstruct(planes.data() + index, count);
+}
+
+void rns_vector::set(std::size_t index, const bigint& value) {
+    basis->reduce(value, planes.data() + index, count);
+}
+
+std::vector<bigint> rns_vector::to_bigints() const {
+    std::vector<bigint> result(count);
+
+    for_ranges(count, planes.size(), [this, &result](std::size_t first, std::size_t last) {
+        for (std::size_t j = first; j < last; j++) result[j] = get(j);
+    });
+
+    return result;
+}
+
+const rns_vector::word* rns_vector::residues(std::size_t prime) const {
+    return plane(prime);
+}
+
+//! Out-of-class operators
+
+rns_vector operator+(const rns_vector& self, const rns_vector& other) {
+    rns_vector result = self;
+    return result += other;
+}
+
+rns_vector operator-(const rns_vector& self, const rns_vector& other) {
+    rns_vector result = self;
+    return result -= other;
+}
+
+rns_vector operator*(const rns_vector& self, const rns_vector& other) {
+    rns_vector result = self;
+    return result *= other;
+}
+
+rns_vector operator*(const rns_vector& self, const bigint& factor) {
+    rns_vector result = self;
+    return result *= factor;
+}
+
+bigint dot_product(const rns_vector& a, const rns_vector& b) {
+    const rns_basis& basis = a.base();
+    if (&basis != &b.base() || a.size() != b.size()) throw std::invalid_argument("rns_vector: the operands differ in basis or size");
+
+    std::vector<rns_basis::word> residues(basis.size());
+
+    for_ranges(basis.size(), basis.size() * a.size(), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            residues[i] = field_kernels::dot_product(a.residues(i), b.residues(i), a.size(), basis.prime(i), basis.inverses[i]);
+        }
+    });
+
+    return basis.reconstruct(residues.data());
+}
@@ -0,0 +1,150 @@
+#ifndef RNS_H
+#define RNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Big_int/Bigint.h"
+
+class rns_vector;
+
+//! Residue number system: integers carried as their residues modulo a basis of primes
+//! p_0, ..., p_(k-1) below 2^32, so sums and products work on each prime independently,
+//! with no carries between them, and only the final values are reconstructed.
+//!
+//! The basis represents the integers in (-M / 2, M / 2], M = p_0 ... p_(k-1). Residues are
+//! in the Montgomery form x 2^32 mod p_i of number_field, and an rns_vector keeps those of all
+//! its values modulo p_i side by side, so the element-wise operations are the vectorized
+//! field_kernels, one call per prime, spread over the bigint thread pool for large vectors
+//! (see limbs::set_thread_count). Rns.cpp, Field_kernels.cpp and Big_int have to be compiled in
+class rns_basis {
+public:
+    using word = std::uint32_t;
+
+    //! Values are reconstructed in blocks of up to this many consecutive primes by Garner's
+    //! algorithm, in O(b^2) word operations per block, vectorized as dot products. The blocks
+    //! are then combined by the CRT over a product tree, which is what keeps large bases subquadratic
+    static constexpr std::size_t garner_limit = 128;
+private:
+    std::vector<word> primes;
+    std::vector<word> inverses; // p_i^-1 mod 2^32
+    std::vector<word> r2;       // 2^64 mod p_i, to enter the Montgomery form
+
+    //! Block b holds the primes [block_starts[b], block_starts[b + 1]), M_b is their product
+    std::vector<std::size_t> block_starts;
+
+    //! Garner: for p_i in a block starting at s, (p_s ... p_(j-1)) mod p_i for s <= j < i at
+    //! radix_offsets[i] + j - s, and (p_s ... p_(i-1))^-1 mod p_i, both in Montgomery form
+    std::vector<word> garner_radices;
+    std::vector<std::size_t> radix_offsets;
+    std::vector<word> garner_inverses;
+
+    //! CRT: (M / M_b)^-1 mod p_i for p_i in block b, as a plain residue, so a Montgomery product
+    //! with it both scales a residue and leaves the form. Garner's algorithm on the scaled
+    //! residues gives y_b = x (M / M_b)^-1 mod M_b, and x = sum of y_b M / M_b mod M
+    std::vector<word> cofactor_inverses;
+
+    //! Product tree over the blocks: levels[0] holds the M_b, each level the products of pairs
+    //! of the one below (an odd one out is carried up), the last one is {M}. Reductions
+    //! go down it as a remainder tree, so every prime only sees a number of the size of its block
+    std::vector<std::vector<bigint>> levels;
+
+    bigint half_product; // floor(M / 2)
+
+    //! The magnitude modulo the primes [first, last) into result, Montgomery form
+    void fold(const bigint::limb* magnitude, std::size_t length, std::size_t first, std::size_t last, word* result) const;
+
+    //! The value in [0, M_b) of block b with residues[i] modulo its i-th prime, not in Montgomery form
+    bigint garner(const word* residues, std::size_t block) const;
+
+    friend class rns_vector;
+    friend bigint dot_product(const rns_vector& a, const rns_vector& b);
+public:
+    //! Rule of five
+
+    //! Throws std::invalid_argument unless the primes are distinct, odd and below 2^32
+    explicit rns_basis(const std::vector<word>& primes);
+
+    //! The count largest primes below 2^32
+    static rns_basis largest_primes(std::size_t count);
+
+    //! Enough of the largest primes below 2^32 for every integer of at most bits bits, with its sign
+    static rns_basis for_bits(std::size_t bits);
+
+    //! Methods
+
+    std::size_t size() const;
+    word prime(std::size_t index) const;
+
+    //! M
+    const bigint& product() const;
+
+    //! residues[i stride] = x mod p_i, Montgomery form. x is taken modulo M
+    void reduce(const bigint& x, word* residues, std::size_t stride = 1) const;
+
+    //! The integer of (-M / 2, M / 2] with the given residues, Montgomery form
+    bigint reconstruct(const word* residues, std::size_t stride = 1) const;
+};
+
+//! A vector of integers over an rns_basis, which must outlive it. Both operands of an
+//! operation must share the basis and the size, std::invalid_argument is thrown otherwise
+class rns_vector {
+public:
+    using word = rns_basis::word;
+private:
+    const rns_basis* basis;
+    std::size_t count;
+    std::vector<word> planes; // value j mod p_i at [i count + j]
+
+    void check(const rns_vector& other) const;
+
+    word* plane(std::size_t index);
+    const word* plane(std::size_t index) const;
+public:
+    //! Rule of five
+
+    //! count zeros
+    rns_vector(const rns_basis& basis, std::size_t count);
+    rns_vector(const rns_basis& basis, const std::vector<bigint>& values);
+
+    //! Arithmetic operators, element-wise and exact as long as the results fit the basis
+
+    rns_vector& operator+=(const rns_vector& other);
+    rns_vector& operator-=(const rns_vector& other);
+    rns_vector& operator*=(const rns_vector& other);
+
+    //! Every value times factor
+    rns_vector& operator*=(const bigint& factor);
+
+    rns_vector operator-() const;
+
+    //! Methods
+
+    //! *this += a b element-wise
+    rns_vector& add_product(const rns_vector& a, const rns_vector& b);
+
+    std::size_t size() const;
+    const rns_basis& base() const;
+
+    bigint get(std::size_t index) const;
+    void set(std::size_t index, const bigint& value);
+
+    //! All the values, reconstructed together
+    std::vector<bigint> to_bigints() const;
+
+    //! The residues of the values modulo the prime of the given index, Montgomery form
+    const word* residues(std::size_t prime) const;
+};
+
+//! Out-of-class operators
+
+rns_vector operator+(const rns_vector& self, const rns_vector& other);
+rns_vector operator-(const rns_vector& self, const rns_vector& other);
+rns_vector operator*(const rns_vector& self, const rns_vector& other);
+rns_vector operator*(const rns_vector& self, const bigint& factor);
+
+//! a_0 b_0 + ... + a_(n-1) b_(n-1), reduced on each prime before a single reconstruction
+bigint dot_product(const rns_vector& a, const rns_vector& b);
+
+#endif // RNS_H
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <random>
+#include "Rns.h"
+
+//! A random integer of at most bits bits, with a random sign
+bigint random_bigint(std::mt19937_64& random, std::size_t bits) {
+    bigint result = 0;
+
+    for (std::size_t i = 0; i < bits; i += 32) result = result * bigint(std::uint64_t(1) << 32) + bigint(random() >> 32);
+    if (random() % 2) result = -result;
+
+    return result;
+}
+
+//! Round trips and arithmetic against bigint, over a basis of the given number of primes,
+//! which takes more than one Garner block above rns_basis::garner_limit
+bool check_basis(std::size_t primes, std::size_t count) {
+    std::mt19937_64 random(primes);
+    rns_basis basis = rns_basis::largest_primes(primes);
+
+    // Products must fit M / 2, so factors of under half of its bits
+    std::size_t bits = primes * 31 / 2 - 32;
+
+    std::vector<bigint> a(count), b(count);
+    for (auto& x : a) x = random_bigint(random, bits);
+    for (auto& x : b) x = random_bigint(random, bits);
+
+    // The extremes of the range (-M / 2, M / 2]
+    a[0] = basis.product() / bigint(2);
+    a[1] = -a[0] + bigint(1);
+
+    rns_vector x(basis, a), y(basis, b);
+    bool result = (x.to_bigints() == a);
+
+    for (std::size_t i = 0; i < count; i++) result &= (x.get(i) == a[i]);
+
+    std::vector<bigint> sums = (x + y).to_bigints(), differences = (x - y).to_bigints();
+
+    // The extremes are left out of the products, which would not fit
+    x.set(0, bigint(0));
+    x.set(1, bigint(-1));
+    a[0] = 0;
+    a[1] = -1;
+
+    std::vector<bigint> products = (x * y).to_bigints();
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (i >= 2) result &= (sums[i] == a[i] + b[i] && differences[i] == a[i] - b[i]);
+        result &= (products[i] == a[i] * b[i]);
+    }
+
+    // The dot product has up to log2(count) more bits than a product
+    std::vector<bigint> small_a(count), small_b(count);
+    bigint small_dot = 0;
+
+    for (std::size_t i = 0; i < count; i++) {
+        small_a[i] = random_bigint(random, bits - 8);
+        small_b[i] = random_bigint(random, bits - 8);
+        small_dot += small_a[i] * small_b[i];
+    }
+
+    return result && dot_product(rns_vector(basis, small_a), rns_vector(basis, small_b)) == small_dot;
+}
+
+int main() {
+    std::cout << "4 primes: " << check_basis(4, 100) << std::endl;
+    std::cout << "128 primes: " << check_basis(128, 50) << std::endl;
+    std::cout << "129 primes: " << check_basis(129, 50) << std::endl;
+    std::cout << "300 primes: " << check_basis(300, 50) << std::endl;
+    std::cout << "1000 primes: " << check_basis(1000, 10) << std::endl;
+}
@@ -0,0 +1,270 @@
+#include "Roots_and_logs.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+template<std::size_t p>
+int legendre(const number_field<p>& a) {
+    if constexpr (p == 2) return a == number_field<p>(0) ? 0 : 1;
+    else return modular::jacobi(a.get_number(), p);
+}
+
+template<std::size_t p>
+number_field<p> square_root(const number_field<p>& a) {
+    using field = number_field<p>;
+    using roots = ntt_roots<p>;
+
+    constexpr int s = roots::two_adicity;
+    constexpr std::uint64_t odd_part = (p - 1) >> s;
+
+    // Past its exponentiation, Tonelli-Shanks takes about s^2 / 4 squarings, Cipolla's algorithm
+    // takes about 4 multiplications per bit of p
+    constexpr bool cipolla = (s * s > 16 * std::numeric_limits<typename field::word>::digits);
+
+    if (p == 2 || a == field(0)) return a;
+
+    field root;
+
+    if constexpr (s == 1) {
+        root = a ^ (p / 4 + 1);
+    } else if constexpr (!cipolla) {
+        // root^2 = a b throughout, and the order 2^i of b drops at each step until b = 1.
+        // b of order 2^s means a is not a square
+        field half = a ^ (odd_part / 2);
+        root = half * a;
+        field b = half * root;
+
+        while (b != field(1)) {
+            int i = 0;
+            for (field power = b; power != field(1) && i < s; power *= power) i++;
+
+            if (i == s) throw std::invalid_argument("square_root: not a square");
+
+            root *= roots::roots[i + 1];
+            b *= roots::roots[i];
+        }
+    } else {
+        // For t^2 - a not a square, (t + w)^((p + 1) / 2) = root in GF(p^2) = GF(p)[w], w^2 = t^2 - a
+        field t(0), w;
+
+        do {
+            t += field(1);
+            w = t * t - a;
+        } while (legendre(w) != -1);
+
+        auto multiply = [&w](field& x0, field& x1, const field& y0, const field& y1) {
+            field low = x0 * y0 + x1 * y1 * w;
+            x1 = x0 * y1 + x1 * y0;
+            x0 = low;
+        };
+
+        field result0(1), result1(0), base0 = t, base1(1);
+
+        for (std::uint64_t e = p / 2 + 1; e > 0; e >>= 1) {
+            if (e & 1) multiply(result0, result1, base0, base1);
+            multiply(base0, base1, base0, base1);
+        }
+
+        root = result0;
+    }
+
+    // The other two methods end up with something else when a is not a square
+    if (root * root != a) throw std::invalid_argument("square_root: not a square");
+
+    if (root.get_number() > p / 2) root = -root;
+
+    return root;
+}
+
+//! Private methods
+
+template<std::size_t p>
+std::size_t discrete_logarithm<p>::baby_steps::position(word key) const {
+    return static_cast<std::size_t>((std::uint64_t(key) * 0x9e3779b97f4a7c15ull) >> shift);
+}
+
+template<std::size_t p>
+discrete_logarithm<p>::baby_steps::baby_steps(const field& gamma, std::uint64_t count) {
+    // At most half full, so probe sequences stay short
+    int bits = 1;
+    while ((std::uint64_t(1) << bits) < 2 * count) bits++;
+
+    slots.assign(std::size_t(1) << bits, slot{0, empty});
+    mask = slots.size() - 1;
+    shift = 64 - bits;
+
+    field power(1);
+
+    for (std::uint64_t j = 0; j < count; j++, power *= gamma) {
+        word key = power.get_number();
+
+        std::size_t i = position(key);
+        while (slots[i].exponent != empty) i = (i + 1) & mask;
+
+        slots[i] = slot{key, static_cast<std::uint32_t>(j)};
+    }
+}
+
+template<std::size_t p>
+std::int64_t discrete_logarithm<p>::baby_steps::find(const field& y) const {
+    word key = y.get_number();
+
+    for (std::size_t i = position(key); slots[i].exponent != empty; i = (i + 1) & mask) {
+        if (slots[i].key == key) return slots[i].exponent;
+    }
+
+    return -1;
+}
+
+template<std::size_t p>
+std::size_t discrete_logarithm<p>::baby_steps::memory() const {
+    return slots.size() * sizeof(slot);
+}
+
+template<std::size_t p>
+std::uint64_t discrete_logarithm<p>::baby_step_giant_step(const subgroup& part, field y) const {
+    for (std::uint64_t i = 0; i < part.prime; i += part.steps) {
+        std::int64_t j = part.table.find(y);
+        if (j >= 0 && i + j < part.prime) return i + j;
+
+        y *= part.giant;
+    }
+
+    throw std::invalid_argument("discrete_log: h is not a power of g");
+}
+
+template<std::size_t p>
+std::uint64_t discrete_logarithm<p>::solve(const subgroup& part, field y) const {
+    std::uint64_t result = 0;
+    std::uint64_t digit_weight = 1; // q^k
+
+    // With the digits below k stripped, y^(q^(e - 1 - k)) = gamma^(digit k)
+    for (int k = 0; k < part.exponent; k++) {
+        std::uint64_t digit = baby_step_giant_step(part, y ^ (part.modulus / digit_weight / part.prime));
+
+        result += digit * digit_weight;
+        if (digit) y *= part.stripping[k] ^ digit;
+
+        digit_weight *= part.prime;
+    }
+
+    return result;
+}
+
+//! Rule of five
+
+template<std::size_t p>
+discrete_logarithm<p>::discrete_logarithm(const field& g) : generator(g), group_order(p - 1) {
+    if (g == field(0)) throw std::invalid_argument("discrete_logarithm: zero has no powers");
+
+    modular::factorization factors = modular::prime_factors(p - 1);
+
+    for (int i = 0; i < factors.count; i++) {
+        std::uint64_t q = factors.primes[i];
+        while (group_order % q == 0 && (g ^ (group_order / q)) == field(1)) group_order /= q;
+    }
+
+    for (int i = 0; i < factors.count; i++) {
+        std::uint64_t q = factors.primes[i];
+        if (group_order % q) continue;
+
+        int exponent = 0;
+        std::uint64_t modulus = 1;
+
+        for (std::uint64_t rest = group_order; rest % q == 0; rest /= q) {
+            exponent++;
+            modulus *= q;
+        }
+
+        std::uint64_t cofactor = group_order / modulus;
+        field base = g ^ cofactor;
+
+        std::vector<field> stripping(exponent);
+        stripping[0] = base.inverse();
+        for (int k = 1; k < exponent; k++) stripping[k] = stripping[k - 1] ^ q;
+
+        field gamma = base ^ (modulus / q);
+
+        std::uint64_t steps = max_baby_steps;
+
+        if (q / max_baby_steps < max_baby_steps) {
+            steps = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(q)));
+            while (steps * steps < q) steps++;
+        }
+
+        subgroups.push_back(subgroup{q, exponent, modulus, cofactor, std::move(stripping),
+                                     steps, gamma.inverse() ^ steps, baby_steps(gamma, steps)});
+    }
+}
+
+//! Methods
+
+template<std::size_t p>
+std::uint64_t discrete_logarithm<p>::operator()(const field& h) const {
+    if (h == field(0)) throw std::invalid_argument("discrete_log: h is not a power of g");
+
+    // Chinese remaindering of x mod q^e over the subgroups, x < combined all along
+    std::uint64_t result = 0, combined = 1;
+
+    for (const subgroup& part : subgroups) {
+        std::uint64_t residue = solve(part, h ^ part.cofactor);
+
+        std::uint64_t known = result % part.modulus;
+        std::uint64_t difference = residue >= known ? residue - known : residue + (part.modulus - known);
+        std::uint64_t lift = modular::multiply(difference, modular::inverse(combined % part.modulus, part.modulus), part.modulus);
+
+        result += combined * lift;
+        combined *= part.modulus;
+    }
+
+    // h outside the group of g can still pass every subgroup
+    if ((generator ^ result) != h) throw std::invalid_argument("discrete_log: h is not a power of g");
+
+    return result;
+}
+
+template<std::size_t p>
+const number_field<p>& discrete_logarithm<p>::base() const {
+    return generator;
+}
+
+template<std::size_t p>
+std::uint64_t discrete_logarithm<p>::order() const {
+    return group_order;
+}
+
+template<std::size_t p>
+std::size_t discrete_logarithm<p>::memory() const {
+    std::size_t result = 0;
+    for (const subgroup& part : subgroups) result += part.table.memory();
+
+    return result;
+}
+
+template<std::size_t p>
+std::uint64_t discrete_log(const number_field<p>& g, const number_field<p>& h) {
+    // Oldest first, with the bytes of all their tables
+    thread_local std::vector<discrete_logarithm<p>> solvers;
+    thread_local std::size_t cached_bytes = 0;
+
+    for (const discrete_logarithm<p>& solver : solvers) {
+        if (solver.base() == g) return solver(h);
+    }
+
+    discrete_logarithm<p> solver(g);
+    std::size_t bytes = solver.memory();
+
+    if (bytes > discrete_log_cache_bytes) return solver(h);
+
+    while (!solvers.empty() && (solvers.size() == discrete_log_cache_bases || cached_bytes + bytes > discrete_log_cache_bytes)) {
+        cached_bytes -= solvers.front().memory();
+        solvers.erase(solvers.begin());
+    }
+
+    cached_bytes += bytes;
+    solvers.push_back(std::move(solver));
+
+    return solvers.back()(h);
+}
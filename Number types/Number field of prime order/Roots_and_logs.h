@@ -0,0 +1,125 @@
+#ifndef ROOTS_AND_LOGS_H
+#define ROOTS_AND_LOGS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Number_field.h"
+#include "NTT.h"
+#include "Modular.h"
+
+//! Square roots and discrete logarithms in number_field<p> for a prime p.
+//! Like NTT.h, a composite p fails to compile
+
+//! The Legendre symbol (a / p): 0 for a = 0, 1 for a nonzero square, -1 otherwise
+template<std::size_t p>
+int legendre(const number_field<p>& a);
+
+//! The root r of r^2 = a with the smaller residue, the other one being -r. Tonelli-Shanks
+//! reads its roots of unity from ntt_roots<p>, Cipolla's algorithm takes over when p - 1 has
+//! so many factors 2 that the Tonelli-Shanks loop would be longer than an exponentiation
+//! in GF(p^2). Throws std::invalid_argument if a is not a square
+template<std::size_t p>
+number_field<p> square_root(const number_field<p>& a);
+
+//! Solves g^x = h for a fixed base g by Pohlig-Hellman: the order of g is split into prime
+//! powers q^e, each digit of x in base q is a discrete logarithm in the subgroup of order q,
+//! found by baby-step giant-step. The baby steps of every subgroup are kept in a hash table
+//! built by the constructor, so a query only takes giant steps. The cost is about sqrt(q)
+//! multiplications for the largest prime q dividing the order of g, a table being capped
+//! at max_baby_steps entries, past which queries take proportionally more giant steps.
+//! A table of n entries takes 2n to 4n slots of sizeof(word) + 4 bytes, padded, so at
+//! most 8 MB at the cap for p above 2^32 and 4 MB below, see memory()
+template<std::size_t p>
+class discrete_logarithm {
+    static_assert(modular::is_prime(p), "discrete_logarithm: p must be prime");
+public:
+    using field = number_field<p>;
+    using word = typename field::word;
+
+    static constexpr std::uint64_t max_baby_steps = std::uint64_t(1) << 18;
+private:
+    //! Open addressing with linear probing over (residue, exponent) pairs side by side, so a
+    //! lookup usually reads one cache line. Indexed by Fibonacci hashing of the residue
+    class baby_steps {
+        static constexpr std::uint32_t empty = ~std::uint32_t(0);
+
+        struct slot {
+            word key;
+            std::uint32_t exponent;
+        };
+
+        std::vector<slot> slots;
+        std::size_t mask;
+        int shift;
+
+        std::size_t position(word key) const;
+    public:
+        //! gamma^j for j < count
+        baby_steps(const field& gamma, std::uint64_t count);
+
+        //! The j with gamma^j = y, or -1 if y is none of them
+        std::int64_t find(const field& y) const;
+
+        std::size_t memory() const;
+    };
+
+    //! The part of the order of g that is a power of the prime q
+    struct subgroup {
+        std::uint64_t prime;
+        int exponent;
+        std::uint64_t modulus; // q^e
+
+        //! The cofactor order / q^e, which takes the problem into the subgroup of order q^e
+        std::uint64_t cofactor;
+
+        //! base^(-q^i) for i < e, base = g^cofactor, to strip the digits found from h
+        std::vector<field> stripping;
+
+        //! gamma = base^(q^(e - 1)) has order q, a giant step multiplies by gamma^-steps
+        std::uint64_t steps;
+        field giant;
+        baby_steps table;
+    };
+
+    field generator;
+    std::uint64_t group_order;
+    std::vector<subgroup> subgroups;
+
+    //! x mod q^e from y = h^cofactor
+    std::uint64_t solve(const subgroup& part, field y) const;
+
+    //! The e with gamma^e = y in the subgroup of order q, throws if there is none
+    std::uint64_t baby_step_giant_step(const subgroup& part, field y) const;
+public:
+    //! Rule of five
+
+    //! Throws std::invalid_argument for g = 0
+    explicit discrete_logarithm(const field& g);
+
+    //! Methods
+
+    //! The x in [0, order()) with g^x = h, throws std::invalid_argument if h is not a power of g
+    std::uint64_t operator()(const field& h) const;
+
+    const field& base() const;
+
+    //! The multiplicative order of g, a divisor of p - 1
+    std::uint64_t order() const;
+
+    //! Bytes held by the baby-step tables
+    std::size_t memory() const;
+};
+
+//! discrete_logarithm<p>(g)(h), with the solvers of the last few bases cached per thread, so
+//! repeated queries for the same g build the tables once. The cache of each thread and p
+//! holds at most discrete_log_cache_bases solvers and discrete_log_cache_bytes of tables,
+//! the oldest solvers making room for new ones. A solver larger than that alone is not kept
+constexpr std::size_t discrete_log_cache_bases = 4;
+constexpr std::size_t discrete_log_cache_bytes = std::size_t(1) << 25;
+
+template<std::size_t p>
+std::uint64_t discrete_log(const number_field<p>& g, const number_field<p>& h);
+
+#endif // ROOTS_AND_LOGS_H
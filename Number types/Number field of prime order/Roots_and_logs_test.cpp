@@ -0,0 +1,101 @@
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include "Number_field.h"
+#include "Number_field.cpp"
+#include "Modular.cpp"
+#include "NTT.cpp"
+#include "../../Polynomials/Polynomial.cpp"
+#include "Roots_and_logs.h"
+#include "Roots_and_logs.cpp"
+
+//! Square roots and Legendre symbols against Euler's criterion a^((p - 1) / 2) = (a / p)
+template<std::size_t p>
+bool check_square_roots() {
+    using field = number_field<p>;
+
+    std::mt19937_64 random(p);
+    bool result = (square_root(field(0)) == field(0) && legendre(field(0)) == 0);
+
+    for (int test = 0; test < 200; test++) {
+        field a(random() % (p - 1) + 1);
+        int symbol = ((a ^ ((p - 1) / 2)) == field(1) ? 1 : -1);
+
+        result &= (legendre(a) == symbol);
+
+        try {
+            field root = square_root(a);
+            result &= (symbol == 1 && root * root == a && root.get_number() <= (-root).get_number());
+        } catch (const std::invalid_argument&) {
+            result &= (symbol == -1);
+        }
+    }
+
+    return result;
+}
+
+//! Discrete logarithms of powers of g, and of an element outside the group generated by g
+template<std::size_t p>
+bool check_logarithms(const number_field<p>& g) {
+    using field = number_field<p>;
+
+    std::mt19937_64 random(p);
+    discrete_logarithm<p> log(g);
+
+    bool result = ((g ^ log.order()) == field(1) && (p - 1) % log.order() == 0);
+
+    for (int test = 0; test < 100; test++) {
+        std::uint64_t x = random() % log.order();
+        field h = g ^ x;
+
+        std::uint64_t found = log(h);
+        result &= (found == x && discrete_log(g, h) == x);
+    }
+
+    if (log.order() < p - 1) {
+        try {
+            log(primitive_root<p>());
+            result = false;
+        } catch (const std::invalid_argument&) {}
+    }
+
+    return result;
+}
+
+//! discrete_log over more bases than its cache keeps, in turns, so solvers are evicted and rebuilt
+template<std::size_t p>
+bool check_cached_logarithms(std::size_t bases) {
+    using field = number_field<p>;
+
+    std::mt19937_64 random(p);
+    field g = primitive_root<p>();
+    bool result = (discrete_logarithm<p>(g).memory() <= discrete_log_cache_bytes);
+
+    for (int round = 0; round < 3; round++) {
+        for (std::size_t i = 0; i < bases; i++) {
+            field base = g ^ (2 * i + 1);
+            std::uint64_t x = random() % (p - 1);
+
+            result &= ((base ^ discrete_log(base, base ^ x)) == (base ^ x));
+        }
+    }
+
+    return result;
+}
+
+int main() {
+    // Tonelli-Shanks, 998244353 = 119 2^23 + 1 by Cipolla's algorithm
+    std::cout << "square roots mod 101: " << check_square_roots<101>() << std::endl;
+    std::cout << "square roots mod 65537: " << check_square_roots<65537>() << std::endl;
+    std::cout << "square roots mod 998244353: " << check_square_roots<998244353>() << std::endl;
+    std::cout << "square roots mod 1000000007: " << check_square_roots<1000000007>() << std::endl;
+    std::cout << "square roots mod 2^61 - 1: " << check_square_roots<2305843009213693951>() << std::endl;
+    std::cout << "square roots mod 2^64 - 59: " << check_square_roots<18446744073709551557ull>() << std::endl;
+
+    // A generator, then elements of smaller order
+    std::cout << "logarithms mod 1000000007: " << check_logarithms<1000000007>(primitive_root<1000000007>()) << std::endl;
+    std::cout << "logarithms mod 998244353: " << check_logarithms<998244353>(number_field<998244353>(3) ^ 7) << std::endl;
+    std::cout << "logarithms mod 2^61 - 1: " << check_logarithms<2305843009213693951>(number_field<2305843009213693951>(37) ^ 4) << std::endl;
+
+    std::cout << "cached logarithms mod 1000000007: " << check_cached_logarithms<1000000007>(discrete_log_cache_bases + 2) << std::endl;
+}
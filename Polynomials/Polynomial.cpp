@@ -3,7 +3,7 @@
 //! Rule of five
 
 template<typename T>
-polynomial<T>::polynomial(const T& scalar): coefficients(std::vector<T>(1, scalar)) {}
+polynomial<T>::polynomial(const T& scalar): coefficients(1, scalar) {}
 
 template<typename T>
 polynomial<T>::polynomial(const std::vector<T>& coefficients): coefficients(coefficients) {}
@@ -14,9 +14,7 @@ polynomial<T>::polynomial(const polynomial<T>& other) {
 }
 
 template<typename T>
-polynomial<T>::polynomial(polynomial<T>&& other) noexcept { 
-    *this = other;
-}
+polynomial<T>::polynomial(polynomial<T>&& other) noexcept: coefficients(std::move(other.coefficients)) {}
 
 template<typename T>
 polynomial<T>& polynomial<T>::operator=(const polynomial<T>& other) { 
@@ -27,7 +25,7 @@ polynomial<T>& polynomial<T>::operator=(const polynomial<T>& other) {
 template<typename T>
 polynomial<T>& polynomial<T>::operator=(polynomial<T>&& other) noexcept {
     if (this != &other) {
-        coefficients = other.coefficients;
+        coefficients = std::move(other.coefficients);
         other.coefficients.clear();
     }
 
@@ -142,7 +140,7 @@ polynomial<T>& polynomial<T>::operator+= (const polynomial<T>& other) {
         i--;
     }
 
-    if (coefficients.empty()) coefficients = std::vector<T>({T(0)});
+    if (coefficients.empty()) coefficients.assign(1, T(0));
 
     return *this;
 }
@@ -192,21 +190,28 @@ polynomial<T> &polynomial<T>::operator%=(const polynomial<T> &other)
 //! Out-of-class operators
 
 template <typename T>
-polynomial<T> operator* (const polynomial<T>& self, const polynomial<T>& other) {
+polynomial<T> schoolbook_product(const polynomial<T>& self, const polynomial<T>& other) {
     polynomial<T> result(T(0));
-    
-    for (int i = 0; i < self.coef().size(); i++) {
-        for (int j = 0; j < other.coef().size(); j++) {
-            int k = i + j;
-            if (result.coef().size() >= k) result.coef().push_back(0);
+    if (self.coef().empty() || other.coef().empty()) return result;
+
+    result.coef().assign(self.coef().size() + other.coef().size() - 1, T(0));
 
-            result[k] += self[i] * other[j];
+    for (std::size_t i = 0; i < self.coef().size(); i++) {
+        for (std::size_t j = 0; j < other.coef().size(); j++) {
+            result[i + j] += self[i] * other[j];
         }
     }
 
+    while (result.coef().size() > 1 && result.coef().back() == T(0)) result.coef().pop_back();
+
     return result;
 }
 
+template <typename T>
+polynomial<T> operator* (const polynomial<T>& self, const polynomial<T>& other) {
+    return schoolbook_product(self, other);
+}
+
 template <typename T>
 polynomial<T> operator+ (const polynomial<T>& self, const polynomial<T>& other) {
     polynomial result(self);
@@ -301,4 +306,4 @@ polynomial<T> gcd(polynomial<T> self, polynomial<T> other) {
     }
 
     return polynomial<T>(T(1));
-}
\ No newline at end of file
+}
@@ -57,4 +57,9 @@ public:
     polynomial& operator%=(const polynomial& other);
 };
 
+//! The product by the double loop, which operator* uses unless T has a faster one
+//! (number_field<p> has the NTT, see NTT.h)
+template<typename T>
+polynomial<T> schoolbook_product(const polynomial<T>& self, const polynomial<T>& other);
+
 #endif // POLYNOMIAL_H
\ No newline at end of file
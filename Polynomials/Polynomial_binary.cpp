@@ -0,0 +1,73 @@
+#include "Polynomial_binary.h"
+
+#include <stdexcept>
+
+template<typename T>
+void write_binary(binary_writer& writer, const polynomial<T>& value) {
+    writer.put(value.coef().size());
+    for (const T& coefficient : value.coef()) write_binary(writer, coefficient);
+}
+
+template<typename T>
+void read_binary(binary_reader& reader, polynomial<T>& value) {
+    std::size_t size = reader.get();
+
+    // Every record takes at least a word, which bounds the allocation for corrupt sizes
+    if (size > reader.remaining()) throw std::runtime_error("binary: truncated data");
+
+    value.coef().clear();
+    value.coef().resize(size);
+    for (T& coefficient : value.coef()) read_binary(reader, coefficient);
+}
+
+template<typename T>
+void skip_binary(binary_reader& reader, binary_tag<polynomial<T>>) {
+    std::size_t size = reader.get();
+    for (std::size_t i = 0; i < size; i++) skip_binary(reader, binary_tag<T>());
+}
+
+//! polynomial_view
+
+template<typename T>
+polynomial_view<T>::polynomial_view(binary_reader& reader) {
+    std::size_t size = reader.get();
+    if (size > reader.remaining()) throw std::runtime_error("binary: truncated data");
+
+    starts.reserve(size + 1);
+
+    for (std::size_t i = 0; i < size; i++) {
+        starts.push_back(reader.current());
+        skip_binary(reader, binary_tag<T>());
+    }
+
+    starts.push_back(reader.current());
+}
+
+template<typename T>
+std::size_t polynomial_view<T>::size() const {
+    return starts.size() - 1;
+}
+
+template<typename T>
+binary_reader polynomial_view<T>::coefficient(std::size_t index) const {
+    return binary_reader(starts[index], starts[index + 1]);
+}
+
+template<typename T>
+T polynomial_view<T>::operator[](std::size_t index) const {
+    binary_reader reader = coefficient(index);
+
+    T result;
+    read_binary(reader, result);
+    return result;
+}
+
+template<typename T>
+polynomial<T> polynomial_view<T>::to_polynomial() const {
+    polynomial<T> result(T(0));
+    result.coef().resize(size());
+
+    for (std::size_t i = 0; i < size(); i++) result[i] = (*this)[i];
+
+    return result;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef POLYNOMIAL_BINARY_H
+#define POLYNOMIAL_BINARY_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Polynomial.h"
+#include "../Number types/Big_int/Binary.h"
+
+//! Binary format of polynomial<T>, see Binary.h: the coefficient count, then the
+//! coefficient records from degree 0 up
+
+template<typename T>
+void write_binary(binary_writer& writer, const polynomial<T>& value);
+
+template<typename T>
+void read_binary(binary_reader& reader, polynomial<T>& value);
+
+template<typename T>
+void skip_binary(binary_reader& reader, binary_tag<polynomial<T>>);
+
+//! A polynomial record in place. The coefficient records are located once,
+//! without reading them, after which any one of them can be loaded or viewed directly
+template<typename T>
+class polynomial_view {
+private:
+    std::vector<const std::uint64_t*> starts; // of every coefficient record, then the end of the last
+public:
+    //! Rule of five
+    //! Consumes a polynomial record
+    explicit polynomial_view(binary_reader& reader);
+
+    //! Methods
+
+    std::size_t size() const;
+
+    //! A reader over exactly the record of coefficient index
+    binary_reader coefficient(std::size_t index) const;
+
+    T operator[](std::size_t index) const;
+    polynomial<T> to_polynomial() const;
+};
+
+#endif // POLYNOMIAL_BINARY_H
@@ -4,6 +4,17 @@
 #include <vector>
 #include <numeric>
 #include <fstream>
+#include <optional>
+#include <type_traits>
+
+#include "../Number types/Number field of prime order/Dynamic_field.h"
+#include "../Number types/Number field of prime order/Dynamic_field.cpp"
+
+//! Products of built-in integers overflow for moduli above 2^32, dynamic_field reduces them in 128 bits
+template<typename vt>
+vt fast_power_mod(vt base, vt exponent, const modulus_context& context) {
+    return static_cast<vt>((dynamic_field(context, base) ^ static_cast<std::uint64_t>(exponent)).get_number());
+}
 
 template<typename vt>
 vt fast_power_mod(vt base, vt exponent, vt mod) {
@@ -27,6 +38,20 @@ bool check_prime(vt number, std::size_t iterations = 10) {
     if (number % 2 == 0) return false; //If it is even it is not prime
     std::srand(time(NULL)); // New seed for random number generation
 
+    // The Montgomery constants of number, computed once for all the powers below
+    std::optional<modulus_context> context;
+    if constexpr (std::is_integral_v<vt>) {
+        if (number > 1) context.emplace(static_cast<std::uint64_t>(number));
+    }
+
+    auto power = [&](vt base, vt exponent) {
+        if constexpr (std::is_integral_v<vt>) {
+            if (context) return fast_power_mod<vt>(base, exponent, *context);
+        }
+
+        return fast_power_mod<vt>(base, exponent, number);
+    };
+
     for (std::size_t i = 0; i < iterations; i++) {
         int a = rand() % (number - 2) + 2;
 
@@ -34,20 +59,20 @@ bool check_prime(vt number, std::size_t iterations = 10) {
             a = rand() % (number - 2) + 2;
         }
 
-        int d = 0, s = 0;
+        int s = 0;
         vt copy = number - 1;
 
         while (copy % 2 == 0) {
             s++;
             copy /= 2;
         }
-        d = copy;
+        vt d = copy;
         
         bool flag = false;
-        vt result = fast_power_mod<vt>(a, d, number); // a^d = 1 mod n
+        vt result = power(a, d); // a^d = 1 mod n
 
         for (vt r = 0; r < s; r++) { //a^(2^r * d)= -1 mod n
-            vt result1 = fast_power_mod<vt>(a, (1 << r) * d, number);
+            vt result1 = power(a, (vt(1) << r) * d);
             if (result1 == number - 1) {
                 flag = true;
                 break;